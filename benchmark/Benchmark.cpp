@@ -0,0 +1,341 @@
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "LatencySummary.h"
+#include "NetworkGenerator.h"
+#include "NodeOrdering.h"
+#include "PathFinding.h"
+#include "RequestProcessor.h"
+#include "RouteNetwork.h"
+#include "SimdKernels.h"
+#include "ThreadPool.h"
+
+/**
+ * @brief Seconds elapsed since a point in time.
+ */
+static double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * @brief Writes one JSON result line to standard output and, if open, to the results file.
+ */
+static void emit(const std::string &run, const std::string &fields, std::ofstream &results) {
+    std::string line = "{" + run + "," + fields + "}\n";
+    std::cout << line;
+    if (results.is_open()) results << line;
+}
+
+/**
+ * @brief Picks a random location ID different from the ones given.
+ */
+static int randomLocation(int n, std::mt19937 &rng, std::initializer_list<int> exclude) {
+    std::uniform_int_distribution<int> pick(1, n);
+    while (true) {
+        int id = pick(rng);
+        if (n <= (int) exclude.size() || std::find(exclude.begin(), exclude.end(), id) == exclude.end()) return id;
+    }
+}
+
+/**
+ * @brief Builds the requests of one benchmark, always from the same seed so every run asks the same queries.
+ */
+static std::vector<Request> makeRequests(RouteNetwork &network, const std::string &kind, int queries, int max_walk, unsigned seed) {
+    int n = network.getNumberOfLocations();
+    std::mt19937 rng(seed);
+    std::vector<Request> requests;
+
+    for (int i = 0; i < queries; i++) {
+        Request request;
+        request.mode = kind == "driving-walking" || kind == "driving-walking-pareto" || kind == "reachability" || kind == "nearest-parking" || kind == "distance" ? kind : "driving";
+        request.src = randomLocation(n, rng, {});
+        request.dest = randomLocation(n, rng, {request.src});
+        if (kind == "time-dependent-driving") request.departureTime = std::uniform_int_distribution<int>(0, MINUTES_PER_DAY - 1)(rng);
+
+        if (kind == "restricted-driving") {
+            for (int k = 0; k < 2; k++) request.avoidNodes.push_back(randomLocation(n, rng, {request.src, request.dest}));
+            Location *from = network.getLocationById(randomLocation(n, rng, {}));
+            if (from != nullptr && !from->getAdj().empty()) {
+                auto *to = static_cast<Location*>(from->getAdj()[0]->getDest(from));
+                request.avoidSegments.emplace_back(std::stoi(from->getId()), std::stoi(to->getId()));
+            }
+        }
+        if (kind == "driving-walking" || kind == "driving-walking-pareto") request.maxWalkTime = max_walk;
+        if (kind == "reachability") {
+            request.travelMode = "driving";
+            request.maxTime = max_walk;
+        }
+        if (kind == "nearest-parking") {
+            request.travelMode = "walking";
+            request.count = 5;
+        }
+        if (kind == "distance") request.travelMode = "driving";
+        requests.push_back(request);
+    }
+    return requests;
+}
+
+/**
+ * @brief Runs the requests one after another and reports throughput and latency percentiles.
+ */
+static std::string runQueries(RouteNetwork &network, std::vector<Request> &requests) {
+    std::vector<double> latencies;
+    latencies.reserve(requests.size());
+    int found = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (Request &request : requests) {
+        auto query_start = std::chrono::steady_clock::now();
+        RouteResult result = RequestProcessor::dispatchRequest(request, network);
+        latencies.push_back(secondsSince(query_start) * 1e6);
+        if (result.status == ROUTE_OK) found++;
+    }
+    double seconds = secondsSince(start);
+
+    std::ostringstream fields;
+    fields << "\"queries\":" << requests.size() << ",\"found\":" << found
+    << ",\"seconds\":" << seconds
+    << ",\"throughput_qps\":" << (seconds > 0 ? requests.size() / seconds : 0)
+    << "," << LatencySummary::toJson(latencies);
+    return fields.str();
+}
+
+/**
+ * @brief Times full searches from random sources, alternating driving and walking.
+ */
+static std::string runOneToAll(RouteNetwork &network, int queries, unsigned seed) {
+    int n = network.getNumberOfLocations();
+    std::mt19937 rng(seed);
+    std::vector<double> latencies;
+    latencies.reserve(queries);
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < queries; i++) {
+        int src = randomLocation(n, rng, {});
+        auto query_start = std::chrono::steady_clock::now();
+        PathFinding::dijkstra(&network, src, i % 2 == 0 ? DRIVING_MODE : WALKING_MODE);
+        latencies.push_back(secondsSince(query_start) * 1e6);
+    }
+    double seconds = secondsSince(start);
+
+    std::ostringstream fields;
+    fields << "\"queries\":" << queries << ",\"threads\":" << network.getSearchThreads()
+    << ",\"seconds\":" << seconds
+    << ",\"throughput_qps\":" << (seconds > 0 ? queries / seconds : 0)
+    << "," << LatencySummary::toJson(latencies);
+    return fields.str();
+}
+
+/**
+ * @brief Times the relaxation kernel over the arcs of every node, against the distances of a full driving search.
+ */
+static std::string runRelaxKernel(RouteNetwork &network, int rounds, unsigned seed) {
+    const RoutingGraph &graph = network.getRoutingGraph();
+    std::mt19937 rng(seed);
+    PathFinding::dijkstra(&network, randomLocation(network.getNumberOfLocations(), rng, {}), DRIVING_MODE);
+    // half the distances are raised, so about half the arcs improve their target and the masks are not all empty
+    std::vector<double> dist = network.getSearchState().dist;
+    for (uint32_t v = 0; v < dist.size(); v += 2) dist[v] += 10;
+
+    long improved = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++) {
+        for (uint32_t u = 0; u < graph.getNumNodes(); u++) {
+            for (uint32_t block = graph.firstArc(u); block < graph.endArc(u); block += SIMD_RELAX_BLOCK) {
+                uint32_t count = std::min<uint32_t>(graph.endArc(u) - block, SIMD_RELAX_BLOCK);
+                improved += __builtin_popcountll(SimdKernels::relaxArcs(graph.getArcData() + block, count, graph.getSegmentData(),
+                                                                        DRIVING_MODE, dist.data(), dist[u]));
+            }
+        }
+    }
+    double seconds = secondsSince(start);
+    uint64_t arcs = uint64_t(rounds) * graph.getNumArcs();
+
+    std::ostringstream fields;
+    fields << "\"level\":\"" << SimdKernels::getLevelName(SimdKernels::getLevel()) << "\",\"arcs\":" << arcs
+    << ",\"improved\":" << improved << ",\"seconds\":" << seconds << ",\"ns_per_arc\":" << (arcs > 0 ? seconds * 1e9 / double(arcs) : 0);
+    return fields.str();
+}
+
+/**
+ * @brief Times hub label queries between random nodes, alternating driving and walking.
+ */
+static std::string runLabelMerge(RouteNetwork &network, int queries, unsigned seed) {
+    const HubLabels &labels = network.getHubLabels();
+    std::uniform_int_distribution<uint32_t> pick(0, network.getRoutingGraph().getNumNodes() - 1);
+    std::mt19937 rng(seed);
+    std::vector<std::pair<uint32_t, uint32_t>> pairs(queries);
+    for (auto &pair : pairs) pair = {pick(rng), pick(rng)};
+
+    double total = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < queries; i++) {
+        double time = labels.query(pairs[i].first, pairs[i].second, i % 2 == 0 ? DRIVING_MODE : WALKING_MODE);
+        if (time < INT_MAX) total += time;
+    }
+    double seconds = secondsSince(start);
+
+    std::ostringstream fields;
+    fields << std::setprecision(15) << "\"level\":\"" << SimdKernels::getLevelName(SimdKernels::getLevel()) << "\",\"queries\":" << queries
+    << ",\"total_time\":" << total << ",\"seconds\":" << seconds << ",\"ns_per_query\":" << (queries > 0 ? seconds * 1e9 / queries : 0);
+    return fields.str();
+}
+
+static void usage(const char *program) {
+    std::cerr << "Usage: " << program << " [--topology grid|geometric|city] [--nodes N] [--parking P] [--no-driving R] [--seed S]\n"
+              << "       [--dir PATH] [--locations FILE --distances FILE] [--queries Q] [--max-walk M] [--results FILE] [--generate-only]\n"
+              << "       [--order input|bfs|rcm|nd] [--cch] [--profiles FILE] [--search-threads N] [--delta W] [--pool-threads N] [--hub-labels] [--label-file FILE] [--simd auto|scalar|sse4|avx2]\n"
+              << "Generates a synthetic network (or uses the given files), loads it and benchmarks each request type.\n"
+              << "With --cch unrestricted searches use a customizable contraction hierarchy, whose customization is timed too.\n"
+              << "With --profiles the time-of-day profiles are loaded and unrestricted driving is also timed at random departure times.\n"
+              << "The one-to-all benchmark times full searches, run by delta-stepping on --search-threads threads when above 1.\n"
+              << "With --pool-threads the shared thread pool (customization, batches) has N workers.\n"
+              << "With --hub-labels distance requests are answered from hub labels, read from and saved to --label-file if given.\n"
+              << "With --simd the queries use vector kernels; the kernel benchmarks time every level the processor supports.\n"
+              << "Both driving-walking benchmarks use --max-walk as their walking limit and reachability requests as their driving budget.\n"
+              << "Results are printed as JSON lines and appended to the results file." << std::endl;
+}
+
+int main(int argc, char *argv[]) {
+    GeneratorOptions options;
+    std::string dir = ".", location_file, route_file, results_file, profile_file, label_file;
+    int queries = 100;
+    int max_walk = 20;
+    int order = ORDER_INPUT;
+    int search_threads = 1;
+    double delta = 0;
+    bool generate_only = false;
+    bool hierarchy = false;
+    bool hub_labels = false;
+    int simd = SIMD_SCALAR;
+
+    for (int i = 1; i < argc; i++) {
+        std::string option = argv[i];
+        if (option == "--generate-only") {
+            generate_only = true;
+            continue;
+        }
+        if (option == "--cch") {
+            hierarchy = true;
+            continue;
+        }
+        if (option == "--hub-labels") {
+            hub_labels = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            usage(argv[0]);
+            return 1;
+        }
+        std::string value = argv[++i];
+        if (option == "--topology" && NetworkGenerator::parseTopology(value, options.topology)) continue;
+        else if (option == "--nodes") options.nodes = std::stol(value);
+        else if (option == "--parking") options.parkingDensity = std::stod(value);
+        else if (option == "--no-driving") options.noDrivingRatio = std::stod(value);
+        else if (option == "--seed") options.seed = std::stoul(value);
+        else if (option == "--dir") dir = value;
+        else if (option == "--locations") location_file = value;
+        else if (option == "--distances") route_file = value;
+        else if (option == "--queries") queries = std::stoi(value);
+        else if (option == "--max-walk") max_walk = std::stoi(value);
+        else if (option == "--results") results_file = value;
+        else if (option == "--profiles") profile_file = value;
+        else if (option == "--search-threads") search_threads = std::stoi(value);
+        else if (option == "--delta") delta = std::stod(value);
+        else if (option == "--pool-threads") ThreadPool::setSharedThreads(std::stoi(value));
+        else if (option == "--label-file") {
+            hub_labels = true;
+            label_file = value;
+        }
+        else if (option == "--order" && NodeOrdering::parseOrder(value, order)) continue;
+        else if (option == "--simd" && SimdKernels::parseLevel(value, simd) && SimdKernels::setLevel(simd)) continue;
+        else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (location_file.empty() != route_file.empty()) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    std::ofstream results;
+    if (!results_file.empty()) results.open(results_file, std::ios::app);
+
+    std::ostringstream run;
+    std::string topology = NetworkGenerator::getTopologyName(options.topology);
+
+    if (location_file.empty()) {
+        std::string prefix = dir + "/" + topology + "_" + std::to_string(options.nodes) + "_";
+        location_file = prefix + "Locations.csv";
+        route_file = prefix + "Distances.csv";
+        run << "\"topology\":\"" << topology << "\",\"nodes\":" << options.nodes << ",\"seed\":" << options.seed
+        << ",\"parking\":" << options.parkingDensity << ",\"no_driving\":" << options.noDrivingRatio;
+
+        long segments = 0;
+        auto start = std::chrono::steady_clock::now();
+        if (!NetworkGenerator::generate(options, location_file, route_file, segments)) {
+            std::cerr << "Could not write " << location_file << " and " << route_file << std::endl;
+            return 1;
+        }
+        emit(run.str(), "\"benchmark\":\"generate\",\"segments\":" + std::to_string(segments)
+             + ",\"seconds\":" + std::to_string(secondsSince(start)), results);
+    }
+    else run << "\"dataset\":\"" << location_file << "\"";
+
+    if (generate_only) return 0;
+
+    run << ",\"order\":\"" << NodeOrdering::getOrderName(order) << "\",\"cch\":" << (hierarchy ? "true" : "false")
+    << ",\"hub_labels\":" << (hub_labels ? "true" : "false") << ",\"simd\":\"" << SimdKernels::getLevelName(SimdKernels::getLevel()) << "\"";
+
+    RouteNetwork network;
+    network.setNodeOrder(order);
+    network.setHierarchy(hierarchy);
+    network.setProfileFile(profile_file);
+    network.setSearchThreads(search_threads, delta);
+    network.setHubLabels(hub_labels, label_file);
+    auto start = std::chrono::steady_clock::now();
+    if (!network.parseData(location_file, route_file)) return 1;
+    emit(run.str(), "\"benchmark\":\"load\",\"locations\":" + std::to_string(network.getNumberOfLocations())
+         + ",\"seconds\":" + std::to_string(secondsSince(start)), results);
+
+    if (hierarchy) {
+        start = std::chrono::steady_clock::now();
+        network.getHierarchy().customize(network.getRoutingGraph());
+        emit(run.str(), "\"benchmark\":\"customize\",\"edges\":" + std::to_string(network.getHierarchy().getNumEdges())
+             + ",\"seconds\":" + std::to_string(secondsSince(start)), results);
+    }
+
+    if (hub_labels) {
+        const HubLabels &labels = network.getHubLabels();
+        emit(run.str(), "\"benchmark\":\"hub-labels\",\"driving_entries\":" + std::to_string(labels.getNumEntries(DRIVING_MODE))
+             + ",\"walking_entries\":" + std::to_string(labels.getNumEntries(WALKING_MODE)), results);
+    }
+
+    std::vector<std::string> kinds = {"unrestricted-driving", "restricted-driving", "driving-walking", "driving-walking-pareto",
+                                      "reachability", "nearest-parking", "distance"};
+    if (!profile_file.empty()) kinds.push_back("time-dependent-driving");
+    for (const std::string &kind : kinds) {
+        std::vector<Request> requests = makeRequests(network, kind, queries, max_walk, options.seed);
+        emit(run.str(), "\"benchmark\":\"" + kind + "\"," + runQueries(network, requests), results);
+    }
+    emit(run.str(), "\"benchmark\":\"one-to-all\"," + runOneToAll(network, queries, options.seed), results);
+
+    int selected = SimdKernels::getLevel();
+    for (int level = SIMD_SCALAR; level <= SimdKernels::detectLevel(); level++) {
+        SimdKernels::setLevel(level);
+        emit(run.str(), "\"benchmark\":\"relax-kernel\"," + runRelaxKernel(network, 20, options.seed), results);
+        if (hub_labels) emit(run.str(), "\"benchmark\":\"label-merge\"," + runLabelMerge(network, queries * 1000, options.seed), results);
+    }
+    SimdKernels::setLevel(selected);
+
+    return 0;
+}
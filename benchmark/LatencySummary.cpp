@@ -0,0 +1,25 @@
+#include "LatencySummary.h"
+
+#include <algorithm>
+#include <sstream>
+
+double LatencySummary::percentile(const std::vector<double> &sorted, double p) {
+    if (sorted.empty()) return 0;
+    size_t rank = std::min(sorted.size() - 1, (size_t) (p / 100.0 * sorted.size()));
+    return sorted[rank];
+}
+
+std::string LatencySummary::toJson(std::vector<double> &samples, const std::string &prefix) {
+    std::sort(samples.begin(), samples.end());
+    double sum = 0;
+    for (double s : samples) sum += s;
+
+    std::ostringstream fields;
+    fields << "\"" << prefix << "mean_us\":" << (samples.empty() ? 0 : sum / samples.size())
+    << ",\"" << prefix << "p50_us\":" << percentile(samples, 50)
+    << ",\"" << prefix << "p90_us\":" << percentile(samples, 90)
+    << ",\"" << prefix << "p99_us\":" << percentile(samples, 99)
+    << ",\"" << prefix << "p999_us\":" << percentile(samples, 99.9)
+    << ",\"" << prefix << "max_us\":" << (samples.empty() ? 0 : samples.back());
+    return fields.str();
+}
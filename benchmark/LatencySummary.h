@@ -0,0 +1,30 @@
+#ifndef LATENCYSUMMARY_H
+#define LATENCYSUMMARY_H
+
+#include <string>
+#include <vector>
+
+/**
+ * @class LatencySummary
+ * @brief Summarizes latency samples as JSON fields shared by the benchmark tools.
+ */
+class LatencySummary {
+public:
+    /**
+    * @brief Gets the value below which a percentage of the sorted samples fall.
+    * @param sorted Samples in increasing order.
+    * @param p The percentile, between 0 and 100.
+    * @return The percentile, or 0 if there are no samples.
+    */
+    static double percentile(const std::vector<double> &sorted, double p);
+
+    /**
+    * @brief Formats mean, p50, p90, p99, p99.9 and max of the samples as JSON fields (without braces).
+    * @param samples Latencies in microseconds, sorted in place.
+    * @param prefix Prefix of the field names (e.g. "service_" gives "service_p50_us").
+    * @return The fields, such as "\"mean_us\":12.5,\"p50_us\":10,...".
+    */
+    static std::string toJson(std::vector<double> &samples, const std::string &prefix = "");
+};
+
+#endif //LATENCYSUMMARY_H
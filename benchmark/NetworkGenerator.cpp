@@ -0,0 +1,159 @@
+#include "NetworkGenerator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <vector>
+
+bool NetworkGenerator::parseTopology(const std::string &name, int &topology) {
+    if (name == "grid") topology = TOPOLOGY_GRID;
+    else if (name == "geometric") topology = TOPOLOGY_GEOMETRIC;
+    else if (name == "city") topology = TOPOLOGY_CITY;
+    else return false;
+    return true;
+}
+
+std::string NetworkGenerator::getTopologyName(int topology) {
+    switch (topology) {
+        case TOPOLOGY_GEOMETRIC: return "geometric";
+        case TOPOLOGY_CITY: return "city";
+        default: return "grid";
+    }
+}
+
+void NetworkGenerator::writeSegment(std::ostream &out, long u, long v, int driving, int walking, double no_driving, std::mt19937 &rng) {
+    std::uniform_real_distribution<double> coin(0.0, 1.0);
+    out << 'N' << u << ",N" << v << ',';
+    if (coin(rng) < no_driving) out << 'X';
+    else out << driving;
+    out << ',' << walking << '\n';
+}
+
+long NetworkGenerator::generateGrid(const GeneratorOptions &options, std::ostream &out, std::mt19937 &rng) {
+    long side = (long) std::ceil(std::sqrt((double) options.nodes));
+    std::uniform_int_distribution<int> driving_time(1, 5);
+    std::uniform_int_distribution<int> walking_factor(4, 7);
+    long segments = 0;
+
+    for (long id = 1; id <= options.nodes; id++) {
+        long col = (id - 1) % side;
+        for (long next : {col + 1 < side ? id + 1 : 0L, id + side}) {
+            if (next == 0 || next > options.nodes) continue;
+            int driving = driving_time(rng);
+            writeSegment(out, id, next, driving, driving * walking_factor(rng), options.noDrivingRatio, rng);
+            segments++;
+        }
+    }
+    return segments;
+}
+
+long NetworkGenerator::generateGeometric(const GeneratorOptions &options, std::ostream &out, std::mt19937 &rng) {
+    long n = options.nodes;
+    const double pi = std::acos(-1.0);
+    double radius = std::sqrt(6.0 / (pi * n));
+    long cells = std::max(1L, (long) (1.0 / radius));
+    std::uniform_real_distribution<float> coordinate(0.0f, 1.0f);
+    std::uniform_real_distribution<double> walking_factor(5.0, 7.0);
+
+    std::vector<float> x(n), y(n);
+    std::vector<long> cell_of(n), cell_start(cells * cells + 1, 0), order(n);
+    for (long i = 0; i < n; i++) {
+        x[i] = coordinate(rng);
+        y[i] = coordinate(rng);
+        long cx = std::min(cells - 1, (long) (x[i] * cells));
+        long cy = std::min(cells - 1, (long) (y[i] * cells));
+        cell_of[i] = cy * cells + cx;
+        cell_start[cell_of[i] + 1]++;
+    }
+    // counting sort of the points by cell, so the neighbours of a point are found in the 3x3 cells around it
+    for (long c = 0; c < cells * cells; c++) cell_start[c + 1] += cell_start[c];
+    std::vector<long> fill(cell_start.begin(), cell_start.end() - 1);
+    for (long i = 0; i < n; i++) order[fill[cell_of[i]]++] = i;
+
+    long segments = 0;
+    for (long i = 0; i < n; i++) {
+        long cx = cell_of[i] % cells, cy = cell_of[i] / cells;
+        for (long ny = std::max(0L, cy - 1); ny <= std::min(cells - 1, cy + 1); ny++) {
+            for (long nx = std::max(0L, cx - 1); nx <= std::min(cells - 1, cx + 1); nx++) {
+                long c = ny * cells + nx;
+                for (long k = cell_start[c]; k < cell_start[c + 1]; k++) {
+                    long j = order[k];
+                    if (j <= i) continue;
+                    double d = std::hypot(x[i] - x[j], y[i] - y[j]);
+                    if (d > radius) continue;
+                    int driving = std::max(1, (int) std::lround(d / radius * 5));
+                    int walking = std::max(driving + 1, (int) std::lround(driving * walking_factor(rng)));
+                    writeSegment(out, i + 1, j + 1, driving, walking, options.noDrivingRatio, rng);
+                    segments++;
+                }
+            }
+        }
+    }
+    return segments;
+}
+
+long NetworkGenerator::generateCity(const GeneratorOptions &options, std::ostream &out, std::mt19937 &rng) {
+    long side = (long) std::ceil(std::sqrt((double) options.nodes));
+    std::uniform_real_distribution<double> coin(0.0, 1.0);
+    std::uniform_int_distribution<int> local_time(2, 4);
+    std::uniform_int_distribution<int> walking_factor(3, 5);
+
+    // the pedestrian centre covers about 28% of the area, walking only segments go there first
+    const double centre_radius = 0.3, centre_area = std::acos(-1.0) * centre_radius * centre_radius;
+    double centre_ratio = std::min(1.0, options.noDrivingRatio / centre_area);
+    double outer_ratio = std::max(0.0, (options.noDrivingRatio - centre_area * centre_ratio) / (1.0 - centre_area));
+    long segments = 0;
+
+    for (long id = 1; id <= options.nodes; id++) {
+        long row = (id - 1) / side, col = (id - 1) % side;
+        double dx = (col + 0.5) / side - 0.5, dy = (row + 0.5) / side - 0.5;
+        double no_driving = std::hypot(dx, dy) < centre_radius ? centre_ratio : outer_ratio;
+
+        // horizontal street of this row, then vertical street of this column
+        for (int vertical = 0; vertical < 2; vertical++) {
+            long next = vertical ? id + side : (col + 1 < side ? id + 1 : 0);
+            if (next == 0 || next > options.nodes) continue;
+
+            bool arterial = (vertical ? col : row) % 8 == 0;
+            if (!arterial && coin(rng) < 0.1) continue;
+
+            int driving = arterial ? 1 : local_time(rng);
+            int walking = arterial ? walking_factor(rng) + 1 : driving * walking_factor(rng);
+            writeSegment(out, id, next, driving, walking, arterial ? 0 : no_driving, rng);
+            segments++;
+        }
+    }
+    return segments;
+}
+
+bool NetworkGenerator::generate(const GeneratorOptions &options, const std::string &location_file, const std::string &route_file, long &segments) {
+    std::ofstream locations(location_file);
+    std::ofstream routes(route_file);
+    if (!locations.is_open() || !routes.is_open()) return false;
+
+    std::mt19937 rng(options.seed);
+    std::uniform_real_distribution<double> coin(0.0, 1.0);
+
+    locations << "Location,Id,Code,Parking\n";
+    for (long id = 1; id <= options.nodes; id++) {
+        locations << "NODE " << id << ',' << id << ",N" << id << ',' << (coin(rng) < options.parkingDensity ? 1 : 0) << '\n';
+    }
+
+    routes << "Location1,Location2,Driving,Walking\n";
+    switch (options.topology) {
+        case TOPOLOGY_GEOMETRIC: {
+            segments = generateGeometric(options, routes, rng);
+            break;
+        }
+        case TOPOLOGY_CITY: {
+            segments = generateCity(options, routes, rng);
+            break;
+        }
+        default: {
+            segments = generateGrid(options, routes, rng);
+            break;
+        }
+    }
+
+    return locations.good() && routes.good();
+}
@@ -0,0 +1,102 @@
+#ifndef NETWORKGENERATOR_H
+#define NETWORKGENERATOR_H
+
+#include <ostream>
+#include <random>
+#include <string>
+
+#define TOPOLOGY_GRID 0 /**< @brief Square grid with random street times */
+#define TOPOLOGY_GEOMETRIC 1 /**< @brief Random points joined to their neighbours within a radius */
+#define TOPOLOGY_CITY 2 /**< @brief Jittered grid with arterials, dead ends and a pedestrian centre */
+
+/**
+ * @struct GeneratorOptions
+ * @brief Parameters of a synthetic network.
+ */
+typedef struct {
+    int topology = TOPOLOGY_GRID; /**< One of the TOPOLOGY_* topologies. */
+    long nodes = 1000; /**< Number of locations. */
+    double parkingDensity = 0.2; /**< Fraction of locations where it is possible to park. */
+    double noDrivingRatio = 0.05; /**< Fraction of segments that can only be walked ("X" driving time). */
+    unsigned seed = 1; /**< Seed of the random generator, the same options always give the same network. */
+} GeneratorOptions;
+
+/**
+ * @class NetworkGenerator
+ * @brief Writes synthetic networks as Locations.csv and Distances.csv compatible files.
+ *
+ * Location i (1-based) is named "NODE i", has ID i and code "Ni". Segments are written as they are generated,
+ * so networks with millions of locations only keep their coordinates in memory.
+ */
+class NetworkGenerator {
+private:
+    /**
+    * @brief Writes one segment, with a "X" driving time with probability no_driving.
+    * @param out The distances stream.
+    * @param u First location ID.
+    * @param v Second location ID.
+    * @param driving Driving time, in minutes.
+    * @param walking Walking time, in minutes.
+    * @param no_driving Probability of the segment being walking only.
+    * @param rng The random generator.
+    */
+    static void writeSegment(std::ostream &out, long u, long v, int driving, int walking, double no_driving, std::mt19937 &rng);
+
+    /**
+    * @brief Writes the segments of a square grid.
+    * @param options The network parameters.
+    * @param out The distances stream.
+    * @param rng The random generator.
+    * @return The number of segments written.
+    */
+    static long generateGrid(const GeneratorOptions &options, std::ostream &out, std::mt19937 &rng);
+
+    /**
+    * @brief Writes the segments of a random geometric network with an average degree of about six.
+    * @param options The network parameters.
+    * @param out The distances stream.
+    * @param rng The random generator.
+    * @return The number of segments written.
+    */
+    static long generateGeometric(const GeneratorOptions &options, std::ostream &out, std::mt19937 &rng);
+
+    /**
+    * @brief Writes the segments of a city-like network.
+    *
+    * Every eighth street is a fast arterial, a tenth of the local streets is missing,
+    * and walking only segments are concentrated in the centre.
+    * @param options The network parameters.
+    * @param out The distances stream.
+    * @param rng The random generator.
+    * @return The number of segments written.
+    */
+    static long generateCity(const GeneratorOptions &options, std::ostream &out, std::mt19937 &rng);
+
+public:
+    /**
+    * @brief Converts a topology name (grid, geometric, city) to its TOPOLOGY_* value.
+    * @param name The topology name.
+    * @param topology Set to the topology if the name is valid.
+    * @return True if the name is valid, false otherwise.
+    */
+    static bool parseTopology(const std::string &name, int &topology);
+
+    /**
+    * @brief Gets the name of a topology.
+    * @param topology One of the TOPOLOGY_* topologies.
+    * @return The topology name.
+    */
+    static std::string getTopologyName(int topology);
+
+    /**
+    * @brief Generates a network and writes its files.
+    * @param options The network parameters.
+    * @param location_file Path of the locations file.
+    * @param route_file Path of the distances file.
+    * @param segments Set to the number of segments written.
+    * @return True if both files were written, false otherwise.
+    */
+    static bool generate(const GeneratorOptions &options, const std::string &location_file, const std::string &route_file, long &segments);
+};
+
+#endif //NETWORKGENERATOR_H
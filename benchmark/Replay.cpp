@@ -0,0 +1,138 @@
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "LatencySummary.h"
+#include "NodeOrdering.h"
+#include "QueryLog.h"
+#include "RequestProcessor.h"
+#include "RouteNetwork.h"
+#include "SimdKernels.h"
+#include "ThreadPool.h"
+
+static void usage(const char *program) {
+    std::cerr << "Usage: " << program << " <locations.csv> <distances.csv> <query.log> [--speed X] [--results FILE] [--order input|bfs|rcm|nd] [--cch] [--profiles FILE] [--search-threads N] [--delta W] [--pool-threads N] [--hub-labels] [--label-file FILE] [--simd auto|scalar|sse4|avx2]\n"
+              << "Replays a query log against a network. --speed 1 keeps the recorded arrival times, --speed 10 replays ten times\n"
+              << "faster and --speed 0 sends every request as soon as the previous one finishes.\n"
+              << "Results are printed as JSON lines and appended to the results file." << std::endl;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 4) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    double speed = 1;
+    std::string results_file, profile_file, label_file;
+    int order = ORDER_INPUT;
+    int search_threads = 1;
+    double delta = 0;
+    bool hierarchy = false;
+    bool hub_labels = false;
+    int simd = SIMD_SCALAR;
+    for (int i = 4; i < argc; i++) {
+        std::string option = argv[i];
+        if (option == "--cch") {
+            hierarchy = true;
+            continue;
+        }
+        if (option == "--hub-labels") {
+            hub_labels = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            usage(argv[0]);
+            return 1;
+        }
+        std::string value = argv[++i];
+        if (option == "--speed") speed = std::stod(value);
+        else if (option == "--results") results_file = value;
+        else if (option == "--profiles") profile_file = value;
+        else if (option == "--search-threads") search_threads = std::stoi(value);
+        else if (option == "--delta") delta = std::stod(value);
+        else if (option == "--pool-threads") ThreadPool::setSharedThreads(std::stoi(value));
+        else if (option == "--label-file") {
+            hub_labels = true;
+            label_file = value;
+        }
+        else if (option == "--order" && NodeOrdering::parseOrder(value, order)) continue;
+        else if (option == "--simd" && SimdKernels::parseLevel(value, simd) && SimdKernels::setLevel(simd)) continue;
+        else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    std::vector<LoggedRequest> entries;
+    if (!QueryLog::load(argv[3], entries)) {
+        std::cerr << "Could not read query log " << argv[3] << std::endl;
+        return 1;
+    }
+    // server workers may record out of order, requests are replayed in arrival order
+    std::stable_sort(entries.begin(), entries.end(), [](const LoggedRequest &a, const LoggedRequest &b) {
+        return a.timestamp < b.timestamp;
+    });
+
+    RouteNetwork network;
+    network.setNodeOrder(order);
+    network.setHierarchy(hierarchy);
+    network.setProfileFile(profile_file);
+    network.setSearchThreads(search_threads, delta);
+    network.setHubLabels(hub_labels, label_file);
+    if (!network.parseData(argv[1], argv[2])) return 1;
+
+    // response time counts from the scheduled arrival, so it includes waiting behind slower requests
+    std::vector<double> response, service, recorded;
+    std::map<std::string, std::vector<double>> service_by_type;
+    response.reserve(entries.size());
+    service.reserve(entries.size());
+
+    auto start = std::chrono::steady_clock::now();
+    for (LoggedRequest &entry : entries) {
+        auto arrival = start;
+        if (speed > 0) {
+            auto offset = std::chrono::duration<double, std::micro>((entry.timestamp - entries.front().timestamp) / speed);
+            arrival += std::chrono::duration_cast<std::chrono::steady_clock::duration>(offset);
+            std::this_thread::sleep_until(arrival);
+        }
+
+        auto begin = std::chrono::steady_clock::now();
+        if (speed <= 0) arrival = begin;
+        RouteResult result = RequestProcessor::dispatchRequest(entry.request, network);
+        auto end = std::chrono::steady_clock::now();
+
+        double service_us = std::chrono::duration<double, std::micro>(end - begin).count();
+        response.push_back(std::chrono::duration<double, std::micro>(end - arrival).count());
+        service.push_back(service_us);
+        recorded.push_back(entry.latency);
+        service_by_type[RequestProcessor::getStatsType(result)].push_back(service_us);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    double recorded_seconds = entries.empty() ? 0 : (entries.back().timestamp - entries.front().timestamp) / 1e6;
+
+    std::ofstream results;
+    if (!results_file.empty()) results.open(results_file, std::ios::app);
+
+    std::ostringstream summary;
+    summary << "{\"replay\":\"" << argv[3] << "\",\"dataset\":\"" << argv[1] << "\",\"speed\":" << speed
+    << ",\"requests\":" << entries.size() << ",\"seconds\":" << seconds << ",\"recorded_seconds\":" << recorded_seconds
+    << ",\"throughput_qps\":" << (seconds > 0 ? entries.size() / seconds : 0)
+    << "," << LatencySummary::toJson(response)
+    << "," << LatencySummary::toJson(service, "service_")
+    << "," << LatencySummary::toJson(recorded, "recorded_") << "}\n";
+    for (auto &type : service_by_type) {
+        summary << "{\"replay\":\"" << argv[3] << "\",\"type\":\"" << type.first << "\",\"requests\":" << type.second.size()
+        << "," << LatencySummary::toJson(type.second, "service_") << "}\n";
+    }
+
+    std::cout << summary.str();
+    if (results.is_open()) results << summary.str();
+    return 0;
+}
@@ -0,0 +1,119 @@
+#ifndef DA_TP_CLASSES_ARENA
+#define DA_TP_CLASSES_ARENA
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+* @file Arena.h
+* @brief Monotonic arena used by the graph to allocate its vertices and edges.
+*/
+
+#define ARENA_BLOCK_SIZE (64 * 1024) ///< Default size in bytes of each block requested by an arena
+
+/**
+* @class Arena
+* @brief Allocates objects contiguously from large blocks and frees them all at once.
+*
+* Objects are never freed individually. Trivially destructible objects (such as edges) cost nothing at teardown;
+* the destructors of other objects are registered when they are created and run, in reverse order, by release().
+*/
+class Arena {
+public:
+    /**
+    * @brief Constructs an empty arena.
+    * @param block_size Size in bytes of each block, larger objects get a block of their own.
+    */
+    explicit Arena(std::size_t block_size = ARENA_BLOCK_SIZE) : block_size_(block_size) {}
+
+    /**
+    * @brief Destroys every object and frees every block.
+    */
+    ~Arena() { release(); }
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    /**
+    * @brief Reserves uninitialized memory.
+    * @param size Number of bytes.
+    * @param align Required alignment, a power of two.
+    * @return Pointer to the memory, valid until release().
+    */
+    void *allocate(std::size_t size, std::size_t align) {
+        std::uintptr_t offset = (reinterpret_cast<std::uintptr_t>(cursor_) + align - 1) & ~(align - 1);
+        if (cursor_ == nullptr || offset + size > reinterpret_cast<std::uintptr_t>(end_)) {
+            std::size_t capacity = size + align > block_size_ ? size + align : block_size_;
+            char *block = static_cast<char*>(std::malloc(capacity));
+            if (block == nullptr) throw std::bad_alloc();
+            blocks_.push_back(block);
+            reserved_ += capacity;
+            cursor_ = block;
+            end_ = block + capacity;
+            offset = (reinterpret_cast<std::uintptr_t>(cursor_) + align - 1) & ~(align - 1);
+        }
+        cursor_ = reinterpret_cast<char*>(offset + size);
+        used_ += size;
+        return reinterpret_cast<void*>(offset);
+    }
+
+    /**
+    * @brief Constructs an object in the arena.
+    * @tparam U Type of the object.
+    * @param args Arguments forwarded to the constructor.
+    * @return Pointer to the object, valid until release().
+    */
+    template <class U, class... Args>
+    U *create(Args&&... args) {
+        U *object = new (allocate(sizeof(U), alignof(U))) U(std::forward<Args>(args)...);
+        if (!std::is_trivially_destructible<U>::value) {
+            destructors_.push_back({object, [](void *p) { static_cast<U*>(p)->~U(); }});
+        }
+        return object;
+    }
+
+    /**
+    * @brief Destroys every object and frees every block, leaving the arena empty and reusable.
+    */
+    void release() {
+        for (auto it = destructors_.rbegin(); it != destructors_.rend(); it++) it->destroy(it->object);
+        destructors_.clear();
+        for (char *block : blocks_) std::free(block);
+        blocks_.clear();
+        cursor_ = end_ = nullptr;
+        used_ = reserved_ = 0;
+    }
+
+    /**
+    * @brief Gets the number of bytes handed out since the last release.
+    * @return The bytes used by objects, without alignment padding.
+    */
+    std::size_t getBytesUsed() const { return used_; }
+
+    /**
+    * @brief Gets the number of bytes held in blocks.
+    * @return The bytes reserved from the system.
+    */
+    std::size_t getBytesReserved() const { return reserved_; }
+
+private:
+    typedef struct {
+        void *object; ///< Object to destroy
+        void (*destroy)(void *); ///< Calls the destructor of the object's type
+    } Destructor;
+
+    std::size_t block_size_; ///< Size of each new block
+    std::vector<char *> blocks_; ///< Blocks owned by the arena
+    char *cursor_ = nullptr; ///< Next free byte of the current block
+    char *end_ = nullptr; ///< End of the current block
+    std::vector<Destructor> destructors_; ///< Objects with non-trivial destructors, in creation order
+    std::size_t used_ = 0; ///< Bytes handed out
+    std::size_t reserved_ = 0; ///< Bytes held in blocks
+};
+
+#endif /* DA_TP_CLASSES_ARENA */
@@ -10,6 +10,9 @@
 #include <limits>
 #include <algorithm>
 
+#include "Arena.h"
+#include "Span.h"
+
 /**
 * @file Graph.h
 * @brief Header file for the graph structure used in the project.
@@ -30,8 +33,8 @@ class Edge;
 * @class Vertex
 * @brief Represents a vertex in the graph.
 *
-* A vertex holds information about its outgoing edges, incoming edges,
-* distances, and other properties like visited status and indegree.
+* A vertex holds its information and its outgoing edges. Search scratch such as distances
+* and parents lives in per-search arrays over the routing graph, not in the vertices.
 *
 * @tparam T Type of the data held in the vertex.
 */
@@ -44,46 +47,32 @@ public:
     */
     Vertex(T in);
 
-    /**
-    * @brief Comparison operator for sorting in a priority queue.
-    * @param vertex Another vertex to compare against.
-    * @return True if the current vertex's distance is less than the other's.
-    */
-    bool operator<(Vertex<T> & vertex) const; // // required by MutablePriorityQueue
-
     /** Getters and setters for the vertex's properties */
     T getInfo() const;
-    std::vector<Edge<T> *> getAdj() const;
-    bool isVisited() const;
-    bool isProcessing() const;
-    unsigned int getIndegree() const;
-    double getDist() const;
-    Edge<T> *getPath() const;
-    std::vector<Edge<T> *> getIncoming() const;
+    Span<Edge<T> *> getAdj() const;
 
     void setInfo(T info);
-    void setVisited(bool visited);
-    void setProcessing(bool processing);
-
-    int getLow() const;
-    void setLow(int value);
-    int getNum() const;
-    void setNum(int value);
-    int getQueueIndex() const;  // needed for heap
-    void setQueueIndex(int value);    // needed for heap
-
-    void setIndegree(unsigned int indegree);
-    void setDist(double dist);
-    void setPath(Edge<T> *path);
 
     /**
     * @brief Adds an outgoing edge from this vertex to the destination vertex.
+    * @param arena The arena of the graph, which owns the created edge.
     * @param d The destination vertex.
     * @param walking_time The time required to walk along this edge.
     * @param driving_time The time required to drive along this edge.
+    * @param id The segment id of the edge.
     * @return A pointer to the created edge.
     */
-    Edge<T> * addEdge(Vertex<T> *dest,  double walking_time, double driving_time);
+    Edge<T> * addEdge(Arena &arena, Vertex<T> *dest,  double walking_time, double driving_time, unsigned id);
+
+    /**
+    * @brief Adds an existing edge to the outgoing edges of this vertex.
+    *
+    * Used for the reverse direction of an undirected segment, which shares the edge (and its weights)
+    * created for the forward direction.
+    *
+    * @param edge The edge, one of whose endpoints is this vertex.
+    */
+    void addSharedEdge(Edge<T> *edge);
 
     /**
     * @brief Removes an outgoing edge to a specified destination vertex.
@@ -99,28 +88,7 @@ public:
 
 protected:
     T info;                ///< Information of the vertex
-    std::vector<Edge<T> *> adj;  ///< Outgoing edges from the vertex
-
-    // auxiliary fields
-    // used by DFS, BFS, Prim ...
-    bool visited = false; ///< Flag for visited status
-    bool processing = false;  ///< Flag for processing status
-    int low = -1, num = -1; // used by SCC Tarjan
-    unsigned int indegree; // used by topsort
-    double dist = 0;  ///< Shortest distance from source
-    Edge<T> *path = nullptr; ///< Shortest path edge
-
-
-    std::vector<Edge<T> *> incoming; ///< Incoming edges to the vertex
-
-
-    int queueIndex = 0; 		///< Required for heap-based priority queue operations
-
-    /**
-    * @brief Deletes a specific edge from the vertex.
-    * @param edge The edge to be deleted.
-    */
-    void deleteEdge(Edge<T> *edge);
+    std::vector<Edge<T> *> adj;  ///< Outgoing edges from the vertex (shared with the other endpoint for undirected segments), owned by the graph arena
 };
 
 /********************** Edge  ****************************/
@@ -129,8 +97,9 @@ protected:
 * @class Edge
 * @brief Represents an edge in the graph.
 *
-* An edge connects two vertices and stores properties like walking and driving times,
-* as well as flow for flow-related problems.
+* An edge connects two vertices and stores their walking and driving times.
+* An undirected segment is a single edge listed in the adjacency of both endpoints, so its weights are
+* stored once; use getDest(from) to get the far endpoint when walking an adjacency list.
 *
 * @tparam T Type of the data held in the vertices.
 */
@@ -143,34 +112,37 @@ public:
     * @param dest The destination vertex.
     * @param walking_time The time required to walk along this edge.
     * @param driving_time The time required to drive along this edge.
+    * @param id The segment id of the edge.
     */
-    Edge(Vertex<T> *orig, Vertex<T> *dest,  double walking_time, double driving_time);
+    Edge(Vertex<T> *orig, Vertex<T> *dest,  double walking_time, double driving_time, unsigned id);
 
     /** Getters and setters for the edge's properties */
     Vertex<T> * getDest() const;
+
+    /**
+    * @brief Gets the endpoint reached when the edge is followed from the given vertex.
+    * @param from One of the endpoints of the edge.
+    * @return The other endpoint (the vertex itself for a loop).
+    */
+    Vertex<T> * getDest(const Vertex<T> *from) const;
+
+    /**
+    * @brief Gets the segment id of the edge, unique within its graph.
+    * @return The id, between 0 and the number of segments of the graph.
+    */
+    unsigned getId() const;
     double getWalkingTime() const;
     double getDrivingTime() const;
-    bool isSelected() const;
+    void setWalkingTime(double walking_time);
+    void setDrivingTime(double driving_time);
     Vertex<T> * getOrig() const;
-    Edge<T> *getReverse() const;
-    double getFlow() const;
-
-    void setSelected(bool selected);
-    void setReverse(Edge<T> *reverse);
-    void setFlow(double flow);
 protected:
     // used for bidirectional edges
     Vertex<T> *orig; ///< Origin vertex
     Vertex<T> * dest;  ///< Destination vertex
     double walking_time_; ///< Walking time for the edge
     double driving_time_; ///< Driving time for the edge
-    // auxiliary fields
-    bool selected = false; ///< Whether the edge is selected
-
-
-    Edge<T> *reverse = nullptr; ///< Reverse edge for bidirectional edges
-
-    double flow; ///< Flow for flow-related problems
+    unsigned id_; ///< Segment id, shared by both directions of an undirected segment
 };
 
 /********************** Graph  ****************************/
@@ -188,6 +160,19 @@ template <class T>
 class Graph {
 public:
     ~Graph();
+
+    /**
+    * @brief Constructs a vertex in the graph arena and adds it to the graph.
+    * @tparam V Type of the vertex, Vertex<T> or a subclass.
+    * @param args Arguments forwarded to the vertex constructor.
+    * @return A pointer to the vertex, or nullptr if a vertex with the same information already exists.
+    */
+    template <class V, class... Args>
+    V *createVertex(Args&&... args) {
+        V *vertex = arena.template create<V>(std::forward<Args>(args)...);
+        return addVertex(vertex) ? vertex : nullptr;
+    }
+
     /**
     * @brief Finds a vertex in the graph by its information.
     * @param in The information of the vertex to find.
@@ -196,7 +181,7 @@ public:
     Vertex<T> *findVertex(const T &in) const;
 
     /**
-    * @brief Adds a vertex to the graph.
+    * @brief Adds a vertex to the graph. The graph does not take ownership, see createVertex.
     * @param in A pointer to the vertex to add.
     * @return True if the vertex was added, false if it already exists.
     */
@@ -234,6 +219,7 @@ public:
     * @param walking_time The walking time for the edge.
     * @param driving_time The driving time for the edge.
     * @return True if the bidirectional edge was added, false if the vertices don't exist.
+    * @note Both directions share a single edge and segment id.
     */
     bool addBidirectionalEdge(const T &sourc, const T &dest,  double walking_time, double driving_time);
 
@@ -244,13 +230,21 @@ public:
     int getNumVertex() const;
 
     /**
-     * @brief Gets a vector of all the vertices in the graph.
-     * @return A vector containing all vertices.
+    * @brief Gets the number of segments (edges, counting each undirected edge once) added to the graph.
+    * @return The number of segments, one more than the largest segment id.
+    */
+    unsigned getNumSegments() const;
+
+    /**
+     * @brief Gets all the vertices in the graph, without copying them.
+     * @return A view of the vertices, invalidated when vertices are added or removed.
      */
-    std::vector<Vertex<T> *> getVertexSet() const;
+    Span<Vertex<T> *> getVertexSet() const;
 
 protected:
+    Arena arena; ///< Owns the vertices created with createVertex and every edge, all freed with the graph
     std::vector<Vertex<T> *> vertexSet;    ///< Collection of vertices in the graph
+    unsigned numSegments = 0; ///< Number of segment ids handed out
 
     double ** distMatrix = nullptr;   ///< Distance matrix for algorithms like Floyd-Warshall
     int **pathMatrix = nullptr;  //< Path matrix for algorithms like Floyd-Warshall
@@ -276,13 +270,17 @@ Vertex<T>::Vertex(T in): info(in) {}
  * with a given destination vertex (d) and edge weight (w).
  */
 template <class T>
-Edge<T> * Vertex<T>::addEdge(Vertex<T> *d, double walking_time, double driving_time) {
-    auto newEdge = new Edge<T>(this, d, walking_time, driving_time);
+Edge<T> * Vertex<T>::addEdge(Arena &arena, Vertex<T> *d, double walking_time, double driving_time, unsigned id) {
+    auto newEdge = arena.create<Edge<T>>(this, d, walking_time, driving_time, id);
     adj.push_back(newEdge);
-    d->incoming.push_back(newEdge);
     return newEdge;
 }
 
+template <class T>
+void Vertex<T>::addSharedEdge(Edge<T> *edge) {
+    adj.push_back(edge);
+}
+
 /*
  * Auxiliary function to remove an outgoing edge (with a given destination (d))
  * from a vertex (this).
@@ -294,10 +292,9 @@ bool Vertex<T>::removeEdge(T in) {
     auto it = adj.begin();
     while (it != adj.end()) {
         Edge<T> *edge = *it;
-        Vertex<T> *dest = edge->getDest();
+        Vertex<T> *dest = edge->getDest(this);
         if (dest->getInfo() == in) {
-            it = adj.erase(it);
-            deleteEdge(edge);
+            it = adj.erase(it); // the edge memory belongs to the graph arena
             removedEdge = true; // allows for multiple edges to connect the same pair of vertices (multigraph)
         }
         else {
@@ -312,17 +309,7 @@ bool Vertex<T>::removeEdge(T in) {
  */
 template <class T>
 void Vertex<T>::removeOutgoingEdges() {
-    auto it = adj.begin();
-    while (it != adj.end()) {
-        Edge<T> *edge = *it;
-        it = adj.erase(it);
-        deleteEdge(edge);
-    }
-}
-
-template <class T>
-bool Vertex<T>::operator<(Vertex<T> & vertex) const {
-    return this->dist < vertex.dist;
+    adj.clear();
 }
 
 template <class T>
@@ -331,124 +318,33 @@ T Vertex<T>::getInfo() const {
 }
 
 template <class T>
-int Vertex<T>::getLow() const {
-    return this->low;
-}
-
-template <class T>
-void Vertex<T>::setLow(int value) {
-    this->low = value;
-}
-
-template <class T>
-int Vertex<T>::getNum() const {
-    return this->num;
-}
-
-template <class T>
-void Vertex<T>::setNum(int value) {
-    this->num = value;
-}
-
-template <class T>
-int Vertex<T>::getQueueIndex() const {
-    return this->queueIndex;
-}
-
-template <class T>
-void Vertex<T>::setQueueIndex(int value) {
-    this->queueIndex = value;
-}
-
-template <class T>
-std::vector<Edge<T>*> Vertex<T>::getAdj() const {
+Span<Edge<T>*> Vertex<T>::getAdj() const {
     return this->adj;
 }
 
-template <class T>
-bool Vertex<T>::isVisited() const {
-    return this->visited;
-}
-
-template <class T>
-bool Vertex<T>::isProcessing() const {
-    return this->processing;
-}
-
-template <class T>
-unsigned int Vertex<T>::getIndegree() const {
-    return this->indegree;
-}
-
-template <class T>
-double Vertex<T>::getDist() const {
-    return this->dist;
-}
-
-template <class T>
-Edge<T> *Vertex<T>::getPath() const {
-    return this->path;
-}
-
-template <class T>
-std::vector<Edge<T> *> Vertex<T>::getIncoming() const {
-    return this->incoming;
-}
-
 template <class T>
 void Vertex<T>::setInfo(T in) {
     this->info = in;
 }
 
-template <class T>
-void Vertex<T>::setVisited(bool visited) {
-    this->visited = visited;
-}
+/********************** Edge  ****************************/
 
 template <class T>
-void Vertex<T>::setProcessing(bool processing) {
-    this->processing = processing;
-}
+Edge<T>::Edge(Vertex<T> *orig, Vertex<T> *dest, double walking_time, double driving_time, unsigned id): orig(orig), dest(dest), walking_time_(walking_time),driving_time_(driving_time), id_(id) {}
 
 template <class T>
-void Vertex<T>::setIndegree(unsigned int indegree) {
-    this->indegree = indegree;
+Vertex<T> * Edge<T>::getDest() const {
+    return this->dest;
 }
 
 template <class T>
-void Vertex<T>::setDist(double dist) {
-    this->dist = dist;
+Vertex<T> * Edge<T>::getDest(const Vertex<T> *from) const {
+    return from == this->orig ? this->dest : this->orig;
 }
 
 template <class T>
-void Vertex<T>::setPath(Edge<T> *path) {
-    this->path = path;
-}
-
-template <class T>
-void Vertex<T>::deleteEdge(Edge<T> *edge) {
-    Vertex<T> *dest = edge->getDest();
-    // Remove the corresponding edge from the incoming list
-    auto it = dest->incoming.begin();
-    while (it != dest->incoming.end()) {
-        if ((*it)->getOrig()->getInfo() == info) {
-            it = dest->incoming.erase(it);
-        }
-        else {
-            it++;
-        }
-    }
-    delete edge;
-}
-
-/********************** Edge  ****************************/
-
-template <class T>
-Edge<T>::Edge(Vertex<T> *orig, Vertex<T> *dest, double walking_time, double driving_time): orig(orig), dest(dest), walking_time_(walking_time),driving_time_(driving_time) {}
-
-template <class T>
-Vertex<T> * Edge<T>::getDest() const {
-    return this->dest;
+unsigned Edge<T>::getId() const {
+    return this->id_;
 }
 
 template <class T>
@@ -462,38 +358,18 @@ double Edge<T>::getDrivingTime() const {
 }
 
 template <class T>
-Vertex<T> * Edge<T>::getOrig() const {
-    return this->orig;
-}
-
-template <class T>
-Edge<T> *Edge<T>::getReverse() const {
-    return this->reverse;
-}
-
-template <class T>
-bool Edge<T>::isSelected() const {
-    return this->selected;
+void Edge<T>::setWalkingTime(double walking_time) {
+    this->walking_time_ = walking_time;
 }
 
 template <class T>
-double Edge<T>::getFlow() const {
-    return flow;
+void Edge<T>::setDrivingTime(double driving_time) {
+    this->driving_time_ = driving_time;
 }
 
 template <class T>
-void Edge<T>::setSelected(bool selected) {
-    this->selected = selected;
-}
-
-template <class T>
-void Edge<T>::setReverse(Edge<T> *reverse) {
-    this->reverse = reverse;
-}
-
-template <class T>
-void Edge<T>::setFlow(double flow) {
-    this->flow = flow;
+Vertex<T> * Edge<T>::getOrig() const {
+    return this->orig;
 }
 
 /********************** Graph  ****************************/
@@ -504,7 +380,12 @@ int Graph<T>::getNumVertex() const {
 }
 
 template <class T>
-std::vector<Vertex<T> *> Graph<T>::getVertexSet() const {
+unsigned Graph<T>::getNumSegments() const {
+    return numSegments;
+}
+
+template <class T>
+Span<Vertex<T> *> Graph<T>::getVertexSet() const {
     return vertexSet;
 }
 
@@ -558,7 +439,6 @@ bool Graph<T>::removeVertex(const T &in) {
                 u->removeEdge(v->getInfo());
             }
             vertexSet.erase(it);
-            delete v;
             return true;
         }
     }
@@ -576,7 +456,7 @@ bool Graph<T>::addEdge(const T &sourc, const T &dest, double walking_time, doubl
     auto v2 = findVertex(dest);
     if (v1 == nullptr || v2 == nullptr)
         return false;
-    v1->addEdge(v2, walking_time, driving_time);
+    v1->addEdge(arena, v2, walking_time, driving_time, numSegments++);
     return true;
 }
 
@@ -600,10 +480,8 @@ bool Graph<T>::addBidirectionalEdge(const T &sourc, const T &dest,  double walki
     auto v2 = findVertex(dest);
     if (v1 == nullptr || v2 == nullptr)
         return false;
-    auto e1 = v1->addEdge(v2,  walking_time, driving_time);
-    auto e2 = v2->addEdge(v1,   walking_time,  driving_time);
-    e1->setReverse(e2);
-    e2->setReverse(e1);
+    auto e = v1->addEdge(arena, v2, walking_time, driving_time, numSegments++);
+    v2->addSharedEdge(e);
     return true;
 }
 
@@ -0,0 +1,149 @@
+/*
+ * IndexedPriorityQueue.h
+ * Mutable priority queue over node indices, with the keys and positions kept in external arrays.
+ * Same heap operations as the vertex based MutablePriorityQueue, so elements with equal keys
+ * leave the queue in the same order.
+ */
+
+#ifndef DA_TP_CLASSES_INDEXEDPRIORITYQUEUE
+#define DA_TP_CLASSES_INDEXEDPRIORITYQUEUE
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief A mutable min priority queue of node indices.
+ *
+ * The priority of node i is keys[i], read from a vector owned by the caller (usually the distances of a search),
+ * so decreasing a key is done by updating the vector and calling decreaseKey(i).
+ */
+class IndexedPriorityQueue {
+    std::vector<uint32_t> H; ///< The heap, starting at index 1.
+    std::vector<uint32_t> own_pos; ///< Position array used when the caller does not provide one.
+    std::vector<uint32_t> *pos; ///< Position of each node in the heap, 0 if not in the queue.
+    const std::vector<double> *keys; ///< Priority of each node.
+
+    /**
+    * @brief Moves the element at index `i` upwards in the heap to restore heap properties.
+    * @param i Index of the element to move upwards.
+    */
+    void heapifyUp(unsigned i) {
+        uint32_t x = H[i];
+        while (i > 1 && (*keys)[x] < (*keys)[H[i / 2]]) {
+            set(i, H[i / 2]);
+            i = i / 2;
+        }
+        set(i, x);
+    }
+
+    /**
+    * @brief Moves the element at index `i` downwards in the heap to restore heap properties.
+    * @param i Index of the element to move downwards.
+    */
+    void heapifyDown(unsigned i) {
+        uint32_t x = H[i];
+        while (true) {
+            unsigned k = i * 2;
+            if (k >= H.size())
+                break;
+            if (k + 1 < H.size() && (*keys)[H[k + 1]] < (*keys)[H[k]])
+                ++k; // right child of i
+            if (!((*keys)[H[k]] < (*keys)[x]))
+                break;
+            set(i, H[k]);
+            i = k;
+        }
+        set(i, x);
+    }
+
+    /**
+    * @brief Places a node at index `i` of the heap and records its position.
+    */
+    void set(unsigned i, uint32_t x) {
+        H[i] = x;
+        (*pos)[x] = i;
+    }
+
+public:
+    /**
+    * @brief Constructs an empty queue.
+    * @param keys Priority of each node, must outlive the queue.
+    */
+    explicit IndexedPriorityQueue(const std::vector<double> &keys) : own_pos(keys.size(), 0), pos(&own_pos), keys(&keys) {
+        H.reserve(keys.size() + 1);
+        H.push_back(0); // indices start at 1 to simplify parent/child calculations
+    }
+
+    /**
+    * @brief Constructs an empty queue over a position array kept by the caller.
+    *
+    * Avoids allocating and clearing a position for every node when only a few nodes will be queued.
+    * Every entry of the array must be 0, and is 0 again once the queue has been emptied.
+    *
+    * @param keys Priority of each node, must outlive the queue.
+    * @param positions Heap position of each node, must outlive the queue.
+    */
+    IndexedPriorityQueue(const std::vector<double> &keys, std::vector<uint32_t> &positions) : pos(&positions), keys(&keys) {
+        H.push_back(0);
+    }
+
+    IndexedPriorityQueue(const IndexedPriorityQueue&) = delete;
+    IndexedPriorityQueue& operator=(const IndexedPriorityQueue&) = delete;
+
+    /**
+    * @brief Inserts a node.
+    * @param x The node index.
+    */
+    void insert(uint32_t x) {
+        H.push_back(x);
+        heapifyUp(H.size() - 1);
+    }
+
+    /**
+    * @brief Extracts the node with the smallest key.
+    * @return The node index.
+    */
+    uint32_t extractMin() {
+        uint32_t x = H[1];
+        H[1] = H.back();
+        H.pop_back();
+        if (H.size() > 1) heapifyDown(1);
+        (*pos)[x] = 0;
+        return x;
+    }
+
+    /**
+    * @brief Restores the heap after the key of a queued node decreased.
+    * @param x The node index.
+    */
+    void decreaseKey(uint32_t x) {
+        heapifyUp((*pos)[x]);
+    }
+
+    /**
+    * @brief Removes every node from the queue, resetting their positions.
+    */
+    void clear() {
+        for (unsigned i = 1; i < H.size(); i++) (*pos)[H[i]] = 0;
+        H.resize(1);
+    }
+
+    /**
+    * @brief Checks if a node is in the queue.
+    * @param x The node index.
+    * @return True if the node was inserted and not extracted yet.
+    */
+    bool contains(uint32_t x) const {
+        return (*pos)[x] != 0;
+    }
+
+    /**
+    * @brief Checks if the queue is empty.
+    * @return True if the queue is empty.
+    */
+    bool empty() const {
+        return H.size() == 1;
+    }
+};
+
+#endif /* DA_TP_CLASSES_INDEXEDPRIORITYQUEUE */
@@ -0,0 +1,53 @@
+#ifndef DA_TP_CLASSES_SPAN
+#define DA_TP_CLASSES_SPAN
+
+#include <cstddef>
+#include <vector>
+
+/**
+* @file Span.h
+* @brief Read-only view over a contiguous sequence, used to expose containers without copying them.
+*/
+
+/**
+* @class Span
+* @brief Non-owning, read-only view of contiguous elements.
+*
+* A span stays valid while the viewed container is not modified; adding or removing elements
+* (e.g. edges of a vertex) invalidates the spans taken from it.
+*
+* @tparam T Type of the elements.
+*/
+template <class T>
+class Span {
+public:
+    /**
+    * @brief Constructs an empty span.
+    */
+    Span() = default;
+
+    /**
+    * @brief Constructs a span over a range of elements.
+    * @param data Pointer to the first element.
+    * @param size Number of elements.
+    */
+    Span(const T *data, std::size_t size) : data_(data), size_(size) {}
+
+    /**
+    * @brief Constructs a span over every element of a vector.
+    * @param v The vector.
+    */
+    Span(const std::vector<T> &v) : data_(v.data()), size_(v.size()) {}
+
+    const T *begin() const { return data_; }
+    const T *end() const { return data_ + size_; }
+    const T &operator[](std::size_t i) const { return data_[i]; }
+    std::size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+private:
+    const T *data_ = nullptr; ///< First element
+    std::size_t size_ = 0; ///< Number of elements
+};
+
+#endif /* DA_TP_CLASSES_SPAN */
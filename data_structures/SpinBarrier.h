@@ -0,0 +1,48 @@
+#ifndef DA_TP_CLASSES_SPINBARRIER
+#define DA_TP_CLASSES_SPINBARRIER
+
+#include <atomic>
+#include <thread>
+
+/**
+* @file SpinBarrier.h
+* @brief Reusable barrier for a fixed team of threads that synchronizes many times per second.
+*/
+
+/**
+* @class SpinBarrier
+* @brief Barrier that waits by spinning briefly and then yielding, instead of sleeping on a condition variable.
+*
+* Every write made by a thread before wait() is visible to every thread after it returns from the same wait().
+* Waiters yield after a few spins, so teams larger than the number of cores still make progress.
+*/
+class SpinBarrier {
+public:
+    /**
+    * @brief Constructs a barrier.
+    * @param threads Number of threads that call wait() each round.
+    */
+    explicit SpinBarrier(int threads) : threads_(threads) {}
+
+    /**
+    * @brief Waits until every thread of the team reached the barrier.
+    */
+    void wait() {
+        unsigned round = round_.load(std::memory_order_acquire);
+        if (arrived_.fetch_add(1, std::memory_order_acq_rel) + 1 == threads_) {
+            arrived_.store(0, std::memory_order_relaxed);
+            round_.fetch_add(1, std::memory_order_release);
+            return;
+        }
+        for (int spins = 0; round_.load(std::memory_order_acquire) == round; spins++) {
+            if (spins >= 64) std::this_thread::yield();
+        }
+    }
+
+private:
+    const int threads_; ///< Number of threads in the team
+    std::atomic<int> arrived_{0}; ///< Threads that reached the barrier this round
+    std::atomic<unsigned> round_{0}; ///< Number of completed rounds
+};
+
+#endif /* DA_TP_CLASSES_SPINBARRIER */
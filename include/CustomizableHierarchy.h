@@ -0,0 +1,138 @@
+#ifndef CUSTOMIZABLEHIERARCHY_H
+#define CUSTOMIZABLEHIERARCHY_H
+
+#include <cstdint>
+#include <vector>
+
+#include "RoutingGraph.h"
+
+/**
+ * @class CustomizableHierarchy
+ * @brief Customizable contraction hierarchy (CCH) of the routing graph, for fast point-to-point queries.
+ *
+ * Preprocessing only looks at the topology: nodes are ranked by a nested dissection order and contracted
+ * from the lowest rank, adding a shortcut between every two higher neighbours of a contracted node. The
+ * resulting upward edges stay valid for any weights, so new walking or driving times only need the
+ * customization, which recomputes each edge weight from the lower triangles it closes, lowest rank first.
+ *
+ * Queries walk the elimination tree (parent = lowest upward neighbour) from both endpoints and meet at
+ * their common ancestors, so they need no priority queue. Segments are undirected, so one upward weight
+ * per edge and metric serves both directions.
+ */
+class CustomizableHierarchy {
+private:
+    uint32_t num_nodes_ = 0; /**< Number of nodes of the contracted graph. */
+    std::vector<uint32_t> rank_; /**< Rank of each routing graph node. */
+    std::vector<uint32_t> node_; /**< Routing graph node of each rank. */
+    std::vector<uint32_t> first_up_; /**< Upward edges of rank r are first_up_[r] to first_up_[r+1]-1. */
+    std::vector<uint32_t> head_; /**< Upper rank of each edge, increasing within a rank. */
+    std::vector<uint32_t> tail_; /**< Lower rank of each edge. */
+    std::vector<uint32_t> parent_; /**< Elimination tree parent of each rank, NO_NODE for roots. */
+    std::vector<uint32_t> arc_edge_; /**< Edge of each routing graph arc leading upwards, NO_NODE for the others. */
+
+    std::vector<double> weight_[2]; /**< Customized weight of each edge, indexed by WALKING_MODE or DRIVING_MODE. */
+    std::vector<uint32_t> via_[2]; /**< Lowest-rank middle of the triangle giving each weight, NO_NODE when it is a segment. */
+
+    /**
+    * @brief Finds the edge between two ranks.
+    * @param lower The lower rank.
+    * @param upper The higher rank, an upward neighbour of lower.
+    * @return The edge index.
+    */
+    uint32_t findEdge(uint32_t lower, uint32_t upper) const;
+
+    /**
+    * @brief Customizes the weights of one metric.
+    * @param graph The routing graph the hierarchy was built from.
+    * @param isDriving True for driving times, false for walking times.
+    */
+    void customizeMetric(const RoutingGraph &graph, bool isDriving);
+
+    /**
+    * @brief Appends the segments of an edge, replacing shortcuts by the edges they stand for.
+    * @param edge The edge.
+    * @param upwards True to follow it from its lower to its higher rank.
+    * @param isDriving True for driving times, false for walking times.
+    * @param nodes Routing graph nodes reached, one per segment.
+    * @param weights Weight of each of those segments.
+    */
+    void unpack(uint32_t edge, bool upwards, bool isDriving, std::vector<uint32_t> &nodes, std::vector<double> &weights) const;
+
+public:
+    /**
+    * @brief Runs the metric-independent preprocessing: orders and contracts the nodes.
+    * @details **Time Complexity** O(V log V + E + S log S) for the S edges of the contracted graph
+    * @param graph The routing graph.
+    */
+    void build(const RoutingGraph &graph);
+
+    /**
+    * @brief Recomputes the edge weights of both metrics from the current segment weights, one on each of two pool workers.
+    * @details **Time Complexity** O(T) for the T triangles of the contracted graph
+    * @param graph The routing graph the hierarchy was built from, with its current weights.
+    */
+    void customize(const RoutingGraph &graph);
+
+    /**
+    * @brief Computes a shortest path between two nodes.
+    * @details **Time Complexity** O(sum of the upward degrees of the elimination tree ancestors of both nodes)
+    * @param s The source node.
+    * @param t The target node.
+    * @param isDriving True for driving times, false for walking times.
+    * @param state The query arrays of the calling thread, sized on first use.
+    * @param nodes Set to the nodes of the path after s, empty if there is none.
+    * @param weights Set to the weight of the segment reaching each of those nodes.
+    * @return True if there is a path from s to a different node t.
+    */
+    bool query(uint32_t s, uint32_t t, bool isDriving, HierarchySearchState &state, std::vector<uint32_t> &nodes, std::vector<double> &weights) const;
+
+    /**
+    * @brief Gets the number of nodes of the contracted graph.
+    * @return The number of nodes.
+    */
+    uint32_t getNumNodes() const { return num_nodes_; }
+
+    /**
+    * @brief Gets the rank of a node in the contraction order.
+    * @param v The routing graph node.
+    * @return The rank, 0 for the first contracted node.
+    */
+    uint32_t getRank(uint32_t v) const { return rank_[v]; }
+
+    /**
+    * @brief Gets the first upward edge of a rank.
+    * @param r The rank.
+    * @return The edge index.
+    */
+    uint32_t firstUp(uint32_t r) const { return first_up_[r]; }
+
+    /**
+    * @brief Gets the index after the last upward edge of a rank.
+    * @param r The rank.
+    * @return The edge index.
+    */
+    uint32_t endUp(uint32_t r) const { return first_up_[r + 1]; }
+
+    /**
+    * @brief Gets the upper rank of an edge.
+    * @param e The edge index.
+    * @return The rank the edge leads up to.
+    */
+    uint32_t getHead(uint32_t e) const { return head_[e]; }
+
+    /**
+    * @brief Gets the customized weight of an edge.
+    * @param e The edge index.
+    * @param isDriving True for driving times, false for walking times.
+    * @return The weight, infinity if no route of that mode goes through the edge.
+    */
+    double getUpWeight(uint32_t e, bool isDriving) const { return weight_[isDriving][e]; }
+
+    /**
+    * @brief Gets the number of edges of the contracted graph, segments and shortcuts alike.
+    * @return The number of edges.
+    */
+    uint32_t getNumEdges() const { return head_.size(); }
+};
+
+#endif //CUSTOMIZABLEHIERARCHY_H
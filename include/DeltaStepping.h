@@ -0,0 +1,171 @@
+#ifndef DELTASTEPPING_H
+#define DELTASTEPPING_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "QueryStats.h"
+#include "RoutingGraph.h"
+
+#define DELTA_MAX_BUCKETS 65536 /**< @brief Most buckets per worker; the bucket width is raised if the heaviest weight needs more */
+
+class RouteNetwork;
+class SpinBarrier;
+
+/**
+ * @struct Relaxation
+ * @brief A shorter distance found for a node, sent to the worker that owns the node.
+ */
+typedef struct {
+    uint32_t node; /**< The node reached. */
+    uint32_t parent; /**< The node it was reached from. */
+    uint32_t arc; /**< The arc from the parent. */
+    double dist; /**< The new distance. */
+} Relaxation;
+
+/**
+ * @class DeltaStepping
+ * @brief Multithreaded single-source search (Meyer and Sanders' delta-stepping) filling the same arrays as Dijkstra's algorithm.
+ *
+ * Nodes are kept in buckets of width delta by distance. All nodes of the lowest non-empty bucket are expanded at once,
+ * first along their light arcs (weight at most delta) until the bucket stops refilling, then once along their heavy
+ * arcs. Each node is owned by one worker, the only one that writes its distance and parent: the others send it their
+ * relaxations, applied between two barriers. The distances are those of Dijkstra's algorithm; routes of equal length
+ * may be chosen differently.
+ *
+ * The calling thread is worker 0. The other workers are a team of threads started by the first search and kept
+ * asleep between searches, so a search does not start threads of its own. They cannot be tasks of the shared pool:
+ * workers meet at barriers many times per search, which would deadlock if some of them were still queued behind
+ * tasks waiting on the search. Searches from different threads take turns on the team.
+ */
+class DeltaStepping {
+private:
+    int threads_ = 1; /**< Number of workers, including the calling thread. */
+    double delta_ = 0; /**< Bucket width in minutes, 0 to derive it from the weights. */
+    double mean_weight_[2] = {-1, -1}; /**< Mean finite weight, indexed by WALKING_MODE or DRIVING_MODE, -1 until first needed. */
+    double max_weight_[2] = {-1, -1}; /**< Largest finite weight, indexed by WALKING_MODE or DRIVING_MODE, -1 until first needed. */
+    size_t num_buckets_ = 0; /**< Buckets per worker, used cyclically: pending distances never span more. */
+
+    std::vector<std::vector<std::vector<uint32_t>>> buckets_; /**< Nodes of each bucket, per worker, possibly stale. */
+    std::vector<std::vector<Relaxation>> outbox_; /**< Relaxations sent from worker s to worker t, at s * threads_ + t. */
+    std::vector<char> marks_; /**< Whether each node is in the current frontier (bit 0) or was settled in the current bucket (bit 1). */
+    std::vector<size_t> next_bucket_[2]; /**< Lowest non-empty bucket of each worker, double-buffered by round parity. */
+    std::vector<char> active_[2]; /**< Whether the current bucket of each worker refilled, double-buffered by round parity. */
+    std::vector<QueryCounters> counters_; /**< Work of each worker, added to the query statistics of the caller. */
+
+    std::mutex run_mutex_; /**< Held by the running search, which owns the buffers and the team. */
+    std::vector<std::thread> team_; /**< Threads of workers 1..threads_-1, empty until the first search. */
+    std::mutex team_mutex_; /**< Guards the job and the team's progress. */
+    std::condition_variable start_; /**< Wakes the team when a job is posted or the team stops. */
+    std::condition_variable finished_; /**< Wakes the caller when the whole team finished the job. */
+    uint64_t job_ = 0; /**< Number of jobs posted to the team. */
+    int done_ = 0; /**< Team threads that finished the current job. */
+    bool stopping_ = false; /**< Whether the team must exit. */
+    const RoutingGraph *job_graph_ = nullptr; /**< Graph searched by the current job. */
+    const SearchContext *job_context_ = nullptr; /**< Context of the thread that posted the current job. */
+    SearchState *job_state_ = nullptr; /**< Search arrays of the current job. */
+    double job_delta_ = 0; /**< Bucket width of the current job. */
+    SpinBarrier *job_barrier_ = nullptr; /**< Barrier of the current job. */
+
+    /**
+    * @brief Gets the worker owning a node.
+    * @param v The node index.
+    * @return The worker index; nodes are dealt out in runs of 64 to keep neighbours together.
+    */
+    uint32_t owner(uint32_t v) const { return (v >> 6) % threads_; }
+
+    /**
+    * @brief Gets the bucket width used for a travel mode.
+    * @param graph The routing graph.
+    * @param isDriving True for driving times, false for walking times.
+    * @return The configured width, or the mean finite weight of the mode, raised to keep at most DELTA_MAX_BUCKETS buckets.
+    */
+    double getDelta(const RoutingGraph &graph, bool isDriving);
+
+    /**
+    * @brief Runs one worker of the search.
+    * @param graph The routing graph.
+    * @param context The search context of the calling thread, for its blocked nodes and segments.
+    * @param state The search arrays, with the source already at distance 0.
+    * @param delta The bucket width.
+    * @param t The worker index.
+    * @param barrier The barrier shared by the workers.
+    */
+    void work(const RoutingGraph &graph, const SearchContext &context, SearchState &state, double delta, uint32_t t, SpinBarrier &barrier);
+
+    /**
+    * @brief Applies the relaxations sent to a worker, filing the improved nodes in its buckets.
+    * @param state The search arrays.
+    * @param delta The bucket width.
+    * @param t The worker index.
+    */
+    void receive(SearchState &state, double delta, uint32_t t);
+
+    /**
+    * @brief Runs the jobs posted to a team thread until the team stops.
+    * @param t The worker index.
+    * @param seen Number of jobs posted before the thread started.
+    */
+    void serve(uint32_t t, uint64_t seen);
+
+    /**
+    * @brief Stops the team and waits for its threads to exit.
+    */
+    void stopTeam();
+
+public:
+    DeltaStepping() = default;
+
+    /**
+    * @brief Stops the team.
+    */
+    ~DeltaStepping();
+
+    /**
+    * @brief Deleted, the team threads work on the engine they were started for.
+    */
+    DeltaStepping(const DeltaStepping&) = delete;
+
+    /**
+    * @brief Deleted, the team threads work on the engine they were started for.
+    */
+    DeltaStepping& operator=(const DeltaStepping&) = delete;
+
+    /**
+    * @brief Sets the number of workers and the bucket width, stopping the team if its size changes.
+    *
+    * Must not be called while a search runs.
+    *
+    * @param threads Number of workers, at least 1.
+    * @param delta Bucket width in minutes, 0 to use the mean segment weight of the searched mode.
+    */
+    void configure(int threads, double delta);
+
+    /**
+    * @brief Gets the number of workers.
+    * @return The number of workers.
+    */
+    int getThreads() const { return threads_; }
+
+    /**
+    * @brief Forgets the weight statistics the bucket width is derived from, after the weights changed.
+    */
+    void resetDelta();
+
+    /**
+    * @brief Computes the shortest path tree of a source.
+    *
+    * Blocked nodes are reached but not expanded and blocked segments are skipped, as in PathFinding::dijkstra;
+    * they are the ones of the calling thread, whichever thread each worker runs on.
+    *
+    * @details **Time Complexity** O(V+E) work per bucket refill, spread over the workers, plus one barrier round per refill
+    * @param rn The network to search.
+    * @param state The search arrays, sized and reset, with the source, mode and distance 0 of the source set.
+    */
+    void run(RouteNetwork &rn, SearchState &state);
+};
+
+#endif //DELTASTEPPING_H
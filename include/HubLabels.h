@@ -0,0 +1,108 @@
+#ifndef HUBLABELS_H
+#define HUBLABELS_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "CustomizableHierarchy.h"
+#include "RoutingGraph.h"
+
+#define HUB_LABEL_MAGIC 0x4c425548 /**< @brief First four bytes of a label file, "HUBL" */
+#define HUB_LABEL_VERSION 1 /**< @brief Layout version of the label file */
+
+/**
+ * @class HubLabels
+ * @brief Hub labeling of the routing graph, answering driving and walking distances without a search.
+ *
+ * Each node stores a label: a few hub nodes with its distance to each of them, such that every two nodes share a
+ * hub on one of their shortest paths. A distance is the smallest sum over the hubs common to both labels, found by
+ * merging the two labels, which are sorted by hub. The labels follow the order of a contraction hierarchy: the label
+ * of a node is its upward search space, built from the highest rank down from the labels of its upward neighbours,
+ * minus the hubs it already reaches faster through another hub. Segments are undirected, so one label per node and
+ * metric serves both directions.
+ *
+ * Hubs and distances are stored in two flat arrays per metric, one label after another, so a query reads two short
+ * contiguous runs of hubs and only touches the distances of the hubs that match; the runs are merged by
+ * SimdKernels::intersectLabels.
+ */
+class HubLabels {
+private:
+    std::vector<uint32_t> rank_; /**< Rank of each routing graph node, used as its hub number. */
+    std::vector<uint32_t> first_[2]; /**< Label of rank r is entries first_[m][r] to first_[m][r+1]-1, indexed by WALKING_MODE or DRIVING_MODE. */
+    std::vector<uint32_t> hubs_[2]; /**< Hub of each entry, increasing within a label. */
+    std::vector<double> dists_[2]; /**< Distance to the hub of each entry. */
+    uint64_t fingerprint_ = 0; /**< Fingerprint of the routing graph the labels were built for. */
+
+    /**
+    * @brief Builds the labels of one metric.
+    * @param cch The customized hierarchy giving the order and the upward weights.
+    * @param isDriving True for driving times, false for walking times.
+    */
+    void buildMetric(const CustomizableHierarchy &cch, bool isDriving);
+
+public:
+    /**
+    * @brief Removes every label.
+    */
+    void clear();
+
+    /**
+    * @brief Checks if the labels are built.
+    * @return True if there are no labels.
+    */
+    bool empty() const { return rank_.empty(); }
+
+    /**
+    * @brief Builds the labels of both metrics.
+    * @details **Time Complexity** O(V·L²) for labels of L entries
+    * @param graph The routing graph.
+    * @param cch A hierarchy built from the graph and customized with its current weights.
+    */
+    void build(const RoutingGraph &graph, const CustomizableHierarchy &cch);
+
+    /**
+    * @brief Computes the distance between two nodes.
+    *
+    * Equal to the distance of a search up to floating-point rounding, since the weights are added in another order.
+    *
+    * @details **Time Complexity** O(L) for labels of L entries
+    * @param s The source node.
+    * @param t The target node.
+    * @param isDriving True for driving times, false for walking times.
+    * @return The distance, INT_MAX if t cannot be reached.
+    */
+    double query(uint32_t s, uint32_t t, bool isDriving) const;
+
+    /**
+    * @brief Gets the number of label entries of a metric.
+    * @param isDriving True for driving times, false for walking times.
+    * @return The number of hubs over every label.
+    */
+    size_t getNumEntries(bool isDriving) const { return hubs_[isDriving].size(); }
+
+    /**
+    * @brief Computes a fingerprint of the nodes, arcs and weights of a routing graph.
+    * @details **Time Complexity** O(V+E)
+    * @param graph The routing graph.
+    * @return The fingerprint, which changes when the graph is renumbered or a weight changes.
+    */
+    static uint64_t fingerprint(const RoutingGraph &graph);
+
+    /**
+    * @brief Writes the labels to a binary file.
+    * @param label_file The path to the label file.
+    * @return True if the file was written, false otherwise.
+    */
+    bool save(const std::string &label_file) const;
+
+    /**
+    * @brief Reads labels written by save, replacing the current ones.
+    * @param label_file The path to the label file.
+    * @param graph The routing graph the labels must have been built for.
+    * @return True if the labels were read, false if the file is missing, damaged or built for another graph.
+    */
+    bool load(const std::string &label_file, const RoutingGraph &graph);
+};
+
+#endif //HUBLABELS_H
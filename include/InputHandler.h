@@ -79,6 +79,21 @@ class InputHandler {
     */
     static void trimString(std::string &str);
 
+    /**
+    * @brief Reads a time of day written as HH:MM.
+    * @param input The input string, such as "08:30".
+    * @param minutes Set to the minutes after midnight.
+    * @return True if the input is a valid time of day, false otherwise.
+    */
+    static bool parseClockTime(const std::string& input, int &minutes);
+
+    /**
+    * @brief Writes a time of day as HH:MM.
+    * @param minutes Minutes after midnight.
+    * @return The time, such as "08:30".
+    */
+    static std::string formatClockTime(int minutes);
+
     /**
      * @brief Reads from file and transforms into Request
      * @param filepath Path to file to read input
@@ -86,6 +101,33 @@ class InputHandler {
      */
     static Request parseInputFile(const std::string& filepath, bool &correct);
 
+    /**
+     * @brief Reads a request in the key:value format of the input files, one pair per line.
+     *
+     * Driving-walking-pareto requests take the keys of driving-walking requests. Driving and both driving-walking
+     * requests may end with a DepartureTime:HH:MM line, making them time-dependent.
+     *
+     * @param in Stream holding the request lines.
+     * @param correct A reference to a boolean that indicates whether parsing was successful.
+     * @return Request with the read values.
+     */
+    static Request parseRequest(std::istream& in, bool &correct);
+
+    /**
+     * @brief Reads a request written in a single line, with its key:value pairs separated by ';'.
+     * @param line Line such as "Mode:driving;Source:3;Destination:8".
+     * @param correct A reference to a boolean that indicates whether parsing was successful.
+     * @return Request with the read values.
+     */
+    static Request parseRequestLine(const std::string& line, bool &correct);
+
+    /**
+     * @brief Writes a request in the single line form read by parseRequestLine.
+     * @param request The request to write.
+     * @return Line such as "Mode:driving;Source:3;Destination:8;AvoidNodes:;AvoidSegments:;IncludeNode:".
+     */
+    static std::string formatRequestLine(const Request& request);
+
     /**
     * @brief Parses driving-related request parameters from key-value pairs.
     * @param request The request object to be populated.
@@ -106,6 +148,36 @@ class InputHandler {
     */
     static void parseDrivingWalking(Request &request, std::string key, std::string value, int index, bool &correct);
 
+    /**
+    * @brief Parses reachability request parameters from key-value pairs.
+    * @param request The request object to be populated.
+    * @param key The key representing the request parameter.
+    * @param value The value associated with the key.
+    * @param index The index of the parameter in the input data.
+    * @param correct A reference to a boolean that indicates whether parsing was successful.
+    */
+    static void parseReachability(Request &request, std::string key, std::string value, int index, bool &correct);
+
+    /**
+    * @brief Parses nearest parking request parameters from key-value pairs.
+    * @param request The request object to be populated.
+    * @param key The key representing the request parameter.
+    * @param value The value associated with the key.
+    * @param index The index of the parameter in the input data.
+    * @param correct A reference to a boolean that indicates whether parsing was successful.
+    */
+    static void parseNearestParking(Request &request, std::string key, std::string value, int index, bool &correct);
+
+    /**
+    * @brief Parses distance request parameters from key-value pairs.
+    * @param request The request object to be populated.
+    * @param key The key representing the request parameter.
+    * @param value The value associated with the key.
+    * @param index The index of the parameter in the input data.
+    * @param correct A reference to a boolean that indicates whether parsing was successful.
+    */
+    static void parseDistance(Request &request, std::string key, std::string value, int index, bool &correct);
+
     /**
     * @brief Parses a comma-separated string of integers into a vector of integers.
     * @param input The input string containing integers separated by commas.
@@ -2,6 +2,7 @@
 #define LOCATION_H
 
 #include <Graph.h>
+#include <cstdint>
 #include <string>
 
 /**
@@ -15,6 +16,7 @@ private:
     std::string id_;
     std::string code_;
     bool canPark_;
+    uint32_t index_ = 0; /**< Node index of the location in the routing graph. */
 public:
 
     /**
@@ -68,6 +70,18 @@ public:
     */
     void setCanPark(bool canPark);
 
+    /**
+    * @brief Gets the node index of the location in the routing graph.
+    * @return The node index.
+    */
+    uint32_t getIndex() const;
+
+    /**
+    * @brief Sets the node index of the location in the routing graph.
+    * @param index The node index.
+    */
+    void setIndex(uint32_t index);
+
     /**
     * @brief Prints the location's information.
     */
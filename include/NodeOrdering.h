@@ -0,0 +1,82 @@
+#ifndef NODEORDERING_H
+#define NODEORDERING_H
+
+#include <string>
+#include <vector>
+
+#include "RoutingGraph.h"
+
+#define ORDER_INPUT 0 /**< @brief Nodes keep the order of the locations file */
+#define ORDER_BFS 1 /**< @brief Nodes in breadth-first order, so neighbours get nearby indices */
+#define ORDER_RCM 2 /**< @brief Reverse Cuthill-McKee order, breadth-first by increasing degree and reversed */
+#define ORDER_ND 3 /**< @brief Nested dissection order, each separator after the two parts it separates */
+
+/**
+ * @class NodeOrdering
+ * @brief Computes node orders that place neighbouring nodes close together in memory.
+ *
+ * Road networks have small bandwidth under a breadth-first numbering, so a search touching a node
+ * mostly touches distance, parent and arc entries that are already in cache.
+ */
+class NodeOrdering {
+public:
+    /**
+    * @brief Computes a node order.
+    * @details **Time Complexity** O(V log V + E)
+    * @param graph The routing graph, in its current numbering.
+    * @param order One of the ORDER_* orders.
+    * @return order[i] is the current index of the node that becomes node i.
+    */
+    static std::vector<uint32_t> compute(const RoutingGraph &graph, int order);
+
+    /**
+    * @brief Parses an order name as given on the command line.
+    * @param name One of "input", "bfs", "rcm" or "nd".
+    * @param order Set to the matching ORDER_* order.
+    * @return True if the name is valid.
+    */
+    static bool parseOrder(const std::string &name, int &order);
+
+    /**
+    * @brief Gets the command line name of an order.
+    * @param order One of the ORDER_* orders.
+    * @return The name.
+    */
+    static const char *getOrderName(int order);
+
+private:
+    /**
+    * @brief Numbers the nodes breadth-first, one component after the other.
+    * @param graph The routing graph.
+    * @param byDegree If true, components start at a node of minimum degree and neighbours are visited
+    * by increasing degree (Cuthill-McKee); otherwise both follow index order.
+    * @return The nodes in visiting order.
+    */
+    static std::vector<uint32_t> breadthFirst(const RoutingGraph &graph, bool byDegree);
+
+    /**
+    * @brief Orders the nodes by recursive bisection with breadth-first level separators.
+    *
+    * A connected piece is split by the smallest breadth-first level (from a far node) that leaves at least
+    * a quarter of the piece on each side, or else by the median level. The separator takes the last
+    * positions of the piece and both sides are ordered the same way before it; a piece that is not
+    * connected is split into its components first.
+    *
+    * @param graph The routing graph.
+    * @return The nodes in order.
+    */
+    static std::vector<uint32_t> nestedDissection(const RoutingGraph &graph);
+
+    /**
+    * @brief Visits a piece breadth-first from a node.
+    * @param graph The routing graph.
+    * @param start The first node, in the piece.
+    * @param piece Piece of each node; only nodes of the piece of start are visited.
+    * @param level Set to the number of segments from start of each visited node.
+    * @param nodes Set to the visited nodes, in visiting order.
+    */
+    static void pieceLevels(const RoutingGraph &graph, uint32_t start, const std::vector<uint32_t> &piece,
+                            std::vector<uint32_t> &level, std::vector<uint32_t> &nodes);
+};
+
+#endif //NODEORDERING_H
@@ -0,0 +1,136 @@
+#ifndef OUTPUTSINK_H
+#define OUTPUTSINK_H
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#define SINK_SESSION 0 /**< @brief One output file per session, truncated once when first written */
+#define SINK_APPEND 1 /**< @brief One output file per session, appending to previous results */
+#define SINK_PER_REQUEST 2 /**< @brief One numbered output file per request */
+#define SINK_STDOUT 3 /**< @brief Results are only written to the standard output */
+#define SINK_NONE 4 /**< @brief Results are only kept in the buffer of the current request */
+
+#define FORMAT_TEXT 0 /**< @brief Results in the human-readable format of the input/output examples */
+#define FORMAT_JSONL 1 /**< @brief One JSON object per result and line */
+#define FORMAT_BINARY 2 /**< @brief Length-prefixed binary records */
+
+#define DEFAULT_OUTPUT_FILE "../output/output.txt" /**< @brief Output file used by the interactive menus */
+
+/**
+ * @class OutputSink
+ * @brief Buffered destination of request results.
+ *
+ * Each request is formatted into an in-memory buffer which is handed to the standard output and/or the
+ * output file when the request ends. The file is opened once and never flushed explicitly,
+ * so writing many results costs no more than the data itself.
+ */
+class OutputSink {
+private:
+    int mode_; /**< One of the SINK_* modes. */
+    int format_ = FORMAT_TEXT; /**< One of the FORMAT_* result formats. */
+    std::string path_; /**< Output file path (base path in per-request mode). */
+    bool echo_; /**< Whether results are also written to the standard output. */
+    std::ofstream file_; /**< Output file, opened on the first result. */
+    std::ostringstream buffer_; /**< Text of the current request. */
+    int requests_ = 0; /**< Number of finished requests. */
+    bool failed_ = false; /**< Set when the output file could not be opened. */
+
+    /**
+    * @brief Opens the output file for the next result if it is not open yet.
+    * @return True if there is a file to write to.
+    */
+    bool openFile();
+
+public:
+    /**
+    * @brief Constructs an OutputSink.
+    * @param mode One of the SINK_* modes.
+    * @param path Output file path, ignored by SINK_STDOUT and SINK_NONE.
+    * @param echo Whether file results are also written to the standard output (never done for binary results).
+    */
+    explicit OutputSink(int mode = SINK_SESSION, std::string path = DEFAULT_OUTPUT_FILE, bool echo = true);
+
+    /**
+    * @brief Writes any pending result and closes the output file.
+    */
+    ~OutputSink();
+
+    /**
+    * @brief Overloaded stream insertion operator for buffering data of the current request.
+    * @tparam T The type of data to write.
+    * @param data The data to be written.
+    * @return Reference to the current OutputSink object.
+    */
+    template <typename T>
+    OutputSink& operator<<(const T& data) {
+        buffer_ << data;
+        return *this;
+    }
+
+    /**
+    * @brief Overloaded stream insertion operator for handling manipulators (e.g., std::endl).
+    * @details The manipulator only reaches the buffer, so std::endl does not flush any file.
+    * @param func A function pointer to a manipulator like std::endl.
+    * @return Reference to the current OutputSink object.
+    */
+    OutputSink& operator<<(std::ostream& (*func)(std::ostream&)) {
+        buffer_ << func;
+        return *this;
+    }
+
+    /**
+    * @brief Buffers raw bytes of the current request.
+    * @param data Pointer to the bytes.
+    * @param size Number of bytes.
+    */
+    void write(const char *data, size_t size);
+
+    /**
+    * @brief Hands the result of the current request to its destinations and clears the buffer.
+    */
+    void endRequest();
+
+    /**
+    * @brief Retrieves the text buffered for the current request.
+    * @return The buffered text.
+    */
+    std::string str() const;
+
+    /**
+    * @brief Gets the mode of the sink.
+    * @return One of the SINK_* modes.
+    */
+    int getMode() const;
+
+    /**
+    * @brief Gets the format results are written in.
+    * @return One of the FORMAT_* formats.
+    */
+    int getFormat() const;
+
+    /**
+    * @brief Sets the format results are written in.
+    * @param format One of the FORMAT_* formats.
+    */
+    void setFormat(int format);
+
+    /**
+    * @brief Parses a format name as given on the command line.
+    * @param name One of "text", "jsonl" or "binary".
+    * @param format Set to the matching FORMAT_* format.
+    * @return True if the name is valid.
+    */
+    static bool parseFormat(const std::string& name, int &format);
+
+    /**
+    * @brief Parses a mode name as given on the command line.
+    * @param name One of "session", "append", "per-request", "stdout" or "none".
+    * @param mode Set to the matching SINK_* mode.
+    * @return True if the name is valid.
+    */
+    static bool parseMode(const std::string& name, int &mode);
+};
+
+#endif //OUTPUTSINK_H
@@ -4,10 +4,8 @@
 #include <vector>
 #include "Route.h"
 #include "RouteNetwork.h"
-#include "../data_structures/MutablePriorityQueue.h"
+#include "../data_structures/IndexedPriorityQueue.h"
 #include <stack>
-#include <sstream>
-#include "MultiStream.h"
 
 /**
  * @class PathFinding.h
@@ -18,15 +16,44 @@ class PathFinding {
     public:
 
     /**
-    * @brief Relaxes an edge in the shortest path algorithm.
-    * @param route Pointer to the edge being evaluated.
+    * @brief Relaxes an arc in the shortest path algorithm.
+    * @param state The arrays of the running search.
+    * @param graph The routing graph.
+    * @param u The node the arc leaves.
+    * @param arc The arc being evaluated.
     * @param isDriving Boolean flag indicating whether to use driving time or walking time.
     * @return True if the relaxation was successful, otherwise false.
     */
-    static bool relax(Edge<std::string>* route, bool isDriving);
+    static bool relax(SearchState &state, const RoutingGraph &graph, uint32_t u, uint32_t arc, bool isDriving);
 
     /**
-    * @brief Runs Dijkstra's algorithm on the given RouteNetwork.
+    * @brief Relaxes an arc of a time-dependent search, entering it at the departure time plus the distance of u.
+    * @param state The arrays of the running search, whose departure time is set.
+    * @param graph The routing graph.
+    * @param profiles The driving profiles the graph refers to.
+    * @param u The node the arc leaves.
+    * @param arc The arc being evaluated.
+    * @return True if the relaxation was successful, otherwise false.
+    */
+    static bool relaxAt(SearchState &state, const RoutingGraph &graph, const TravelTimeProfiles &profiles, uint32_t u, uint32_t arc);
+
+    /**
+    * @brief Gets the departure time a search in a travel mode would use.
+    * @param rn Pointer to the RouteNetwork.
+    * @param mode Boolean flag indicating whether to use driving mode (true) or walking mode (false).
+    * @return Minutes after midnight for time-dependent driving searches, -1 for the base travel times.
+    */
+    static double searchDeparture(RouteNetwork *rn, bool mode);
+
+    /**
+    * @brief Runs Dijkstra's algorithm on the given RouteNetwork, leaving the result in its search state.
+    *
+    * Driving searches on a time-dependent network start at its departure time and enter each segment at the
+    * time they reach it; the profiles are first-in first-out, so the first arrival at a node is still final.
+    * Other searches run delta-stepping instead when the network has more than one search thread, unless they
+    * run on a worker of the shared thread pool. Without profiles or blocked segments, and with vector kernels
+    * selected, the arcs of each settled node are first compared as one block by SimdKernels::relaxArcs.
+    *
     * @details **Time Complexity** O((V+E)logV)
     * @param rn Pointer to the RouteNetwork.
     * @param src_id The ID of the source location.
@@ -35,7 +62,75 @@ class PathFinding {
     static void dijkstra(RouteNetwork* rn, int src_id, bool mode);
 
     /**
-    * @brief Retrieves the shortest path as a vector of locations.
+    * @brief Brings the last search tree up to date with the nodes and segments blocked since it was computed.
+    *
+    * Blocking only lengthens routes, so only the nodes whose tree path went through a newly blocked node or
+    * segment are searched again, seeded from their unaffected neighbours (Ramalingam and Reps). The distances
+    * are those of a new search; routes of equal length may be chosen differently. Time-dependent trees are
+    * repaired the same way, since with first-in first-out profiles blocking still only delays arrivals.
+    *
+    * @details **Time Complexity** O((A+E')logA) for the A affected nodes and their E' arcs
+    * @param rn Pointer to the RouteNetwork, whose search state holds a valid tree.
+    */
+    static void repairTree(RouteNetwork *rn);
+
+    /**
+    * @brief Makes the search state hold the tree of a source under the current blocks, without a full search if possible.
+    *
+    * Reuses the last tree, or the saved tree without blocks, when it has the same source, mode and departure time, and repairs it.
+    *
+    * @param rn Pointer to the RouteNetwork.
+    * @param src_id The source location ID.
+    * @param mode Boolean flag indicating whether to use driving mode (true) or walking mode (false).
+    * @return True if the search state now holds the tree, false if a full search is needed.
+    */
+    static bool reuseTree(RouteNetwork *rn, int src_id, bool mode);
+
+    /**
+    * @brief Runs Dijkstra's algorithm from one or more sources, stopping at a time budget.
+    *
+    * Only the nodes within the budget are queued or reset, so the cost depends on the area reached
+    * rather than on the size of the network. Blocked nodes are reached but not expanded, as in dijkstra.
+    *
+    * @details **Time Complexity** O((V'+E')logV') for the V' nodes and E' arcs within the budget
+    * @param rn Pointer to the RouteNetwork.
+    * @param sources Routing graph node of each source and its starting distance.
+    * @param isDriving Boolean flag indicating whether to use driving time or walking time.
+    * @param budget Largest distance of a reached node.
+    * @param reached Set to the reached nodes and their distances, by increasing distance.
+    * @param targets (Optional) Whether each node counts towards maxTargets.
+    * @param maxTargets (Optional) Stops once this many target nodes were reached, 0 for no limit.
+    */
+    static void boundedSearch(RouteNetwork *rn, const std::vector<std::pair<uint32_t, double>> &sources, bool isDriving, double budget,
+                              std::vector<std::pair<uint32_t, double>> &reached, const std::vector<char> *targets = nullptr, size_t maxTargets = 0);
+
+    /**
+    * @brief Labels the connected components of the routing graph in a travel mode.
+    *
+    * Segments are undirected, so these are also the strongly connected components:
+    * two nodes share a label exactly when a search from either one reaches the other.
+    *
+    * @details **Time Complexity** O(V+E)
+    * @param graph The routing graph.
+    * @param isDriving If true, segments that cannot be driven are ignored.
+    * @param labels Set to the component of each node.
+    * @return The number of components.
+    */
+    static uint32_t labelComponents(const RoutingGraph &graph, bool isDriving, std::vector<uint32_t> &labels);
+
+    /**
+    * @brief Gets the distance of a location in the last search.
+    * @param rn Pointer to the RouteNetwork.
+    * @param location The location.
+    * @return The distance from the search source, INT_MAX if it was not reached.
+    */
+    static double getDist(RouteNetwork *rn, Location *location);
+
+    /**
+    * @brief Retrieves the shortest path of the last search as a vector of locations.
+    *
+    * The weight of a time-dependent path is its travel time from the departure, the distance of the destination.
+    *
     * @param rn Pointer to the RouteNetwork.
     * @param origin The origin location ID.
     * @param dest The destination location ID.
@@ -46,15 +141,29 @@ class PathFinding {
     static std::vector<Location*> getVectorPath(RouteNetwork *rn, const int &origin, const int &dest, double &weight, bool isDriving);
 
     /**
-    * @brief Prints a simple representation of the path.
+    * @brief Converts a path of locations into the IDs of those locations.
     * @param v The vector of locations representing the path.
-    * @param weight The total weight of the path.
-    * @param call_mode The mode used for displaying location information (ID, Code, or Name).
+    * @return The location IDs, in path order.
+    */
+    static std::vector<int> getIdPath(const std::vector<Location*> &v);
+
+    /**
+    * @brief Computes the shortest path between two locations with the customizable hierarchy of the network.
+    * @param rn Pointer to the RouteNetwork, whose hierarchy is built.
+    * @param source The source location ID.
+    * @param dest The destination location ID.
+    * @param weight Reference to a double storing the total path weight.
+    * @param mode Boolean flag indicating whether to use driving mode (true) or walking mode (false).
+    * @return A vector containing the locations that form the shortest path, empty if there is none.
     */
-    static void printSimplePath(std::vector<Location*> v, double weight, int call_mode, MultiStream out);
+    static std::vector<Location*> getHierarchyPath(RouteNetwork *rn, int source, int dest, double &weight, bool mode);
 
     /**
     * @brief Computes the shortest path between two locations.
+    *
+    * Uses the customizable hierarchy of the network when it has one, nothing is blocked and the search is not
+    * time-dependent, Dijkstra's algorithm otherwise.
+    *
     * @param rn Pointer to the RouteNetwork.
     * @param source The source location ID.
     * @param dest The destination location ID.
@@ -70,7 +179,7 @@ class PathFinding {
     * @param v2 The second path as a vector of locations.
     * @return A merged vector containing the combined path.
     */
-    static std::vector<Location*> mergeIncludePaths(std::vector<Location*> v1, std::vector<Location*> v2);
+    static std::vector<Location*> mergeIncludePaths(const std::vector<Location*> &v1, const std::vector<Location*> &v2);
 
 
 
@@ -0,0 +1,74 @@
+#ifndef QUERYLOG_H
+#define QUERYLOG_H
+
+#include <chrono>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "RequestProcessor.h"
+
+#define QUERY_LOG_FLUSH_EVERY 64 /**< @brief Number of recorded requests between flushes of the log file */
+
+/**
+ * @struct LoggedRequest
+ * @brief A request read back from a query log.
+ */
+typedef struct {
+    long long timestamp = 0; /**< Wall clock time the request started, in microseconds since the Unix epoch. */
+    double latency = 0; /**< Time taken to process and write the request, in microseconds. */
+    Request request; /**< The request. */
+} LoggedRequest;
+
+/**
+ * @class QueryLog
+ * @brief Records every processed request to a log file that can be replayed later.
+ *
+ * Each line of the log holds the start timestamp in microseconds, the latency in microseconds and the request
+ * in the single line form of InputHandler::formatRequestLine, separated by spaces
+ * (e.g. "1760000000000000 512.3 Mode:driving;Source:3;Destination:8;AvoidNodes:;AvoidSegments:;IncludeNode:").
+ * Lines starting with '#' are comments.
+ */
+class QueryLog {
+private:
+    static std::ofstream log_; /**< Log file, closed when not recording. */
+    static std::mutex mutex_; /**< Serializes writers, requests may be recorded by several server workers. */
+    static int unflushed_; /**< Requests written since the last flush. */
+
+public:
+    /**
+    * @brief Starts recording, appending to a log file.
+    * @param path Path of the log file.
+    * @return True if the file could be opened, false otherwise.
+    */
+    static bool open(const std::string &path);
+
+    /**
+    * @brief Flushes and closes the log file.
+    */
+    static void close();
+
+    /**
+    * @brief Checks if requests are being recorded.
+    * @return True if a log file is open.
+    */
+    static bool isRecording();
+
+    /**
+    * @brief Appends a processed request to the log, if recording.
+    * @param request The request.
+    * @param start Time the request started being processed, used to compute its latency.
+    */
+    static void record(const Request &request, std::chrono::steady_clock::time_point start);
+
+    /**
+    * @brief Reads every request of a log file.
+    * @param path Path of the log file.
+    * @param entries Receives the requests, in the order they were recorded.
+    * @return True if the file could be read, false otherwise. Malformed lines are skipped.
+    */
+    static bool load(const std::string &path, std::vector<LoggedRequest> &entries);
+};
+
+#endif //QUERYLOG_H
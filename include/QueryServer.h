@@ -0,0 +1,170 @@
+#ifndef QUERYSERVER_H
+#define QUERYSERVER_H
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "OutputSink.h"
+#include "RouteNetwork.h"
+
+#define DEFAULT_SERVER_PORT 5050 /**< @brief Default localhost TCP port of the query server */
+#define DEFAULT_SERVER_WORKERS 4 /**< @brief Default number of worker threads of the query server */
+#define SERVER_MAX_PENDING 256 /**< @brief Most commands of one connection waiting for a worker before the server stops reading from it */
+#define SERVER_MAX_OUTPUT (1 << 20) /**< @brief Most unsent response bytes of one connection before the server stops reading from it */
+
+#define COMMAND_BLOCK 0 /**< @brief A request of one key:value pair per line */
+#define COMMAND_LINE 1 /**< @brief A request on a single line, with the pairs separated by ';' */
+#define COMMAND_STATS 2 /**< @brief The query statistics */
+#define COMMAND_UPDATE 3 /**< @brief A travel time update file to apply */
+
+/**
+ * @struct ServerCommand
+ * @brief A request or command read from a connection, waiting to be answered.
+ */
+typedef struct {
+    int kind; /**< One of the COMMAND_* kinds. */
+    std::string text; /**< The request, or the update file path. */
+} ServerCommand;
+
+/**
+ * @struct ServerConnection
+ * @brief A client connection, with what was read from it and not yet answered, and what was answered and not yet sent.
+ */
+typedef struct {
+    int fd = -1; /**< The connection socket. */
+    std::string input; /**< Bytes read after the last complete line. */
+    std::string block; /**< Lines of the block request being read. */
+    std::deque<ServerCommand> commands; /**< Commands waiting to be answered, in order. */
+    std::string output; /**< Responses waiting to be sent. */
+    bool busy = false; /**< Whether the connection is queued for a worker or one is answering its next command. */
+    bool closing = false; /**< Whether the client closed its side or sent QUIT; the connection closes once everything is answered and sent. */
+    bool broken = false; /**< Whether sending failed; nothing more is answered or sent. */
+} ServerConnection;
+
+/**
+ * @class QueryServer
+ * @brief Long-running server that answers route requests over a local socket against an already loaded network.
+ *
+ * Requests use the key:value format of the input files, either one pair per line terminated by an empty line,
+ * or a single line with the pairs separated by ';' (e.g. "Mode:driving;Source:3;Destination:8").
+ * A block request cut short by the client closing its side is answered as if the empty line had been sent.
+ * Each response holds the result in the server format: text as written to the output file followed by an empty line,
+ * one JSON line, or one length-prefixed binary record.
+ * A client may send several requests without waiting, responses are returned in the same order.
+ * The line "STATS" returns the query statistics as text followed by an empty line, and the line "QUIT" closes the connection.
+ * The line "UPDATE <file>" applies a travel time update file (see RouteNetwork::applyUpdates) between two requests,
+ * so no search sees a partly updated network, and returns the number of updated segments followed by an empty line.
+ *
+ * One thread polls every connection, splits what it reads into requests and hands each connection with requests
+ * waiting to the workers, which answer one request at a time and queue the connection again if it has more:
+ * connections take turns on the workers, however many stay open, and the requests of one connection are answered
+ * in order. Requests are searched in parallel, each worker in its own search context of the network; an update waits
+ * for the running searches and holds back new ones until it is applied.
+ */
+class QueryServer {
+private:
+    RouteNetwork& route_network_; /**< Network shared by every connection. */
+    int workers_; /**< Number of worker threads answering requests. */
+    int format_; /**< Format of the responses, one of the FORMAT_* formats. */
+    int listen_fd_ = -1; /**< Listening socket. */
+    std::string socket_path_; /**< Path of the Unix domain socket, empty when serving over TCP. */
+    int wake_fds_[2] = {-1, -1}; /**< Pipe the workers write to, so the polling thread sends the responses they add. */
+
+    std::shared_mutex network_mutex_; /**< Shared by the searches, held exclusively while an update changes the network. */
+    std::mutex update_mutex_; /**< Taken by searches before the network lock and held by updates while they wait for it, so a stream of searches cannot starve an update. */
+    std::mutex queue_mutex_; /**< Guards the commands, output and flags of the connections, and the ready queue. */
+    std::condition_variable queue_cv_; /**< Signals workers that a connection has a command waiting. */
+    std::queue<ServerConnection*> ready_; /**< Connections with a command waiting for a worker. */
+    std::unordered_map<int, std::unique_ptr<ServerConnection>> connections_; /**< Open connections, by socket. */
+    bool stopping_ = false; /**< Whether the workers must exit, set under queue_mutex_. */
+
+    /**
+    * @brief Takes connections from the ready queue and answers their next command until the server stops.
+    */
+    void workerLoop();
+
+    /**
+    * @brief Reads what a connection has available and queues its complete commands.
+    * @param connection The connection, whose socket is readable.
+    */
+    void readConnection(ServerConnection& connection);
+
+    /**
+    * @brief Queues a command of a connection, and the connection for a worker if none has it. Must hold queue_mutex_.
+    * @param connection The connection.
+    * @param kind One of the COMMAND_* kinds.
+    * @param text The request, or the update file path.
+    */
+    void queueCommand(ServerConnection& connection, int kind, const std::string& text);
+
+    /**
+    * @brief Sends as much of the pending output of a connection as its socket takes. Must hold queue_mutex_.
+    * @param connection The connection.
+    */
+    void sendOutput(ServerConnection& connection);
+
+    /**
+    * @brief Answers one command.
+    * @param command The command.
+    * @return The response, in the server format.
+    */
+    std::string execute(const ServerCommand& command);
+
+    /**
+    * @brief Applies a travel time update file to the network, waiting for the running searches to finish.
+    * @param update_file The path to the update file.
+    * @return The response, as text followed by an empty line.
+    */
+    std::string applyUpdates(const std::string& update_file);
+
+    /**
+    * @brief Parses and processes one request.
+    * @param request_text The request, in block or single line form.
+    * @param single_line True if the request uses the single line form.
+    * @return The response, in the server format; an invalid result if parsing or processing the request threw.
+    */
+    std::string answer(const std::string& request_text, bool single_line);
+
+public:
+    /**
+    * @brief Constructs a QueryServer over a loaded network.
+    * @param route_network The network used to answer every request.
+    * @param workers Number of worker threads.
+    * @param format Format of the responses, one of the FORMAT_* formats.
+    */
+    QueryServer(RouteNetwork& route_network, int workers = DEFAULT_SERVER_WORKERS, int format = FORMAT_TEXT);
+
+    /**
+    * @brief Closes the listening socket.
+    */
+    ~QueryServer();
+
+    /**
+    * @brief Listens on a localhost TCP port.
+    * @param port The port number.
+    * @return True if the socket is listening, false otherwise.
+    */
+    bool listenTcp(int port);
+
+    /**
+    * @brief Listens on a Unix domain socket, replacing any stale socket file.
+    * @param path The socket file path.
+    * @return True if the socket is listening, false otherwise.
+    */
+    bool listenUnix(const std::string& path);
+
+    /**
+    * @brief Accepts connections and hands their requests to the worker pool. Only returns if polling or accepting fails.
+    */
+    void run();
+};
+
+#endif //QUERYSERVER_H
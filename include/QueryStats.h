@@ -0,0 +1,185 @@
+#ifndef QUERYSTATS_H
+#define QUERYSTATS_H
+
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+
+#define PHASE_PARSE 0 /**< @brief Reading the request */
+#define PHASE_SEARCH 1 /**< @brief Shortest path searches */
+#define PHASE_RECONSTRUCT 2 /**< @brief Building paths from the search trees */
+#define PHASE_OUTPUT 3 /**< @brief Formatting the result */
+#define NUM_PHASES 4
+
+#define HISTOGRAM_BUCKETS 64
+
+/**
+ * @struct QueryCounters
+ * @brief Work done by a single query.
+ */
+typedef struct {
+    unsigned long heapInserts = 0; /**< Vertices inserted in the priority queue. */
+    unsigned long decreaseKeys = 0; /**< Priority decreases in the priority queue. */
+    unsigned long extractMins = 0; /**< Vertices extracted from the priority queue. */
+    unsigned long edgesRelaxed = 0; /**< Edges whose relaxation was attempted. */
+    unsigned long verticesSettled = 0; /**< Extracted vertices whose edges were scanned. */
+    unsigned long blockedHits = 0; /**< Vertices and edges skipped because they are blocked. */
+    unsigned long searches = 0; /**< Shortest path searches run. */
+    double phaseTime[NUM_PHASES] = {0, 0, 0, 0}; /**< Wall time of each phase, in microseconds. */
+} QueryCounters;
+
+/**
+ * @class Histogram
+ * @brief Distribution of non-negative values in power-of-two buckets.
+ */
+class Histogram {
+private:
+    unsigned long buckets_[HISTOGRAM_BUCKETS] = {0}; /**< Bucket i counts values in [2^(i-1), 2^i). */
+    unsigned long count_ = 0; /**< Number of values added. */
+    double sum_ = 0; /**< Sum of the values added. */
+    double min_ = 0; /**< Smallest value added. */
+    double max_ = 0; /**< Largest value added. */
+
+public:
+    /**
+    * @brief Adds a value to the distribution.
+    * @param value The value to add.
+    */
+    void add(double value);
+
+    /**
+    * @brief Estimates a percentile as the upper bound of the bucket that holds it.
+    * @param p The percentile, between 0 and 100.
+    * @return The estimated value.
+    */
+    double percentile(double p) const;
+
+    /**
+    * @brief Writes count, mean, min, p50, p90, p99 and max in one line.
+    * @param name Name of the measured value.
+    * @param out The output stream.
+    */
+    void print(const std::string &name, std::ostream &out) const;
+};
+
+/**
+ * @class QueryStats
+ * @brief Opt-in per query instrumentation, aggregated into histograms per request type.
+ *
+ * While a query is active on a thread, the search code adds its work to the counters returned by current().
+ * When statistics are disabled current() is always nullptr, so the instrumented code only pays a null check.
+ */
+class QueryStats {
+private:
+    static bool enabled_; /**< Whether queries are measured. */
+    static thread_local QueryCounters *current_; /**< Counters of the query active on this thread. */
+    static thread_local std::string *current_type_; /**< Request type of the query active on this thread. */
+    static std::mutex mutex_; /**< Guards the histograms. */
+    static std::map<std::string, std::map<std::string, Histogram>> histograms_; /**< Histograms per request type and metric. */
+
+    /**
+    * @brief Adds the counters of a finished query to the histograms of its type.
+    * @param type The request type.
+    * @param counters The counters of the query.
+    * @param total_us Wall time of the whole query, in microseconds.
+    */
+    static void record(const std::string &type, const QueryCounters &counters, double total_us);
+
+    friend class QueryScope;
+
+public:
+    /**
+    * @brief Enables or disables the statistics.
+    * @param enabled True to measure the next queries.
+    */
+    static void setEnabled(bool enabled);
+
+    /**
+    * @brief Checks if the statistics are enabled.
+    * @return True if queries are measured.
+    */
+    static bool isEnabled();
+
+    /**
+    * @brief Gets the counters of the query active on this thread.
+    * @return Pointer to the counters, or nullptr if there is no measured query.
+    */
+    static QueryCounters *current();
+
+    /**
+    * @brief Sets the request type of the query active on this thread, under which it is aggregated.
+    * @param type The request type (e.g. "driving-walking").
+    */
+    static void setType(const std::string &type);
+
+    /**
+    * @brief Writes the histograms of every request type.
+    * @param out The output stream.
+    */
+    static void dump(std::ostream &out);
+
+    /**
+    * @brief Discards every aggregated query.
+    */
+    static void reset();
+};
+
+/**
+ * @class QueryScope
+ * @brief Measures one query from construction to destruction.
+ *
+ * Scopes nest: only the outermost scope of a thread starts and records a query, so a front end can
+ * open one around parsing while RequestProcessor opens another around processing.
+ */
+class QueryScope {
+private:
+    bool owner_ = false; /**< Whether this scope started the query. */
+    QueryCounters counters_; /**< Counters of the query. */
+    std::string type_ = "unknown"; /**< Request type of the query. */
+    std::chrono::steady_clock::time_point start_; /**< Start of the query. */
+
+public:
+    /**
+    * @brief Starts a query on this thread if statistics are enabled and none is active.
+    * @param type Initial request type of the query.
+    */
+    explicit QueryScope(const std::string &type = "unknown");
+
+    /**
+    * @brief Records the query if this scope started it.
+    */
+    ~QueryScope();
+
+    QueryScope(const QueryScope&) = delete;
+    QueryScope& operator=(const QueryScope&) = delete;
+};
+
+/**
+ * @class PhaseTimer
+ * @brief Adds the wall time of a block to one phase of the active query.
+ */
+class PhaseTimer {
+private:
+    QueryCounters *counters_; /**< Counters of the active query, nullptr if none. */
+    int phase_; /**< One of the PHASE_* phases. */
+    std::chrono::steady_clock::time_point start_; /**< Start of the block. */
+
+public:
+    /**
+    * @brief Starts timing a phase.
+    * @param phase One of the PHASE_* phases.
+    */
+    explicit PhaseTimer(int phase);
+
+    /**
+    * @brief Adds the elapsed time to the phase.
+    */
+    ~PhaseTimer();
+
+    PhaseTimer(const PhaseTimer&) = delete;
+    PhaseTimer& operator=(const PhaseTimer&) = delete;
+};
+
+#endif //QUERYSTATS_H
@@ -4,8 +4,11 @@
 #include <utility>
 #include <vector>
 
-#include "MultiStream.h"
+#include "OutputSink.h"
 #include "RouteNetwork.h"
+#include "RouteResult.h"
+
+#define MAX_PARETO_OPTIONS 8 /**< @brief Largest number of options returned by a Pareto driving-walking request */
 
 /**
  * @struct Request
@@ -13,13 +16,18 @@
  */
 
 typedef struct {
-    std::string mode = ""; /**< Travel mode (e.g., "driving", "driving-walking"). */
+    std::string mode = ""; /**< Travel mode (e.g., "driving", "driving-walking", "driving-walking-pareto", "distance"). */
     int src=-1; /**< Source location ID. */
     int dest=-1; /**< Destination location ID. */
     std::vector<int> avoidNodes; /**< Nodes to avoid in routing. */
     std::vector<std::pair<int, int>> avoidSegments; /**< Edges to avoid in routing. */
     int includeNode = -1; /**< A mandatory intermediate node in the route. */
     int maxWalkTime = -1; /**< Maximum allowed walking time (for mixed modes). */
+    std::string travelMode = ""; /**< "driving", "walking" or "driving-walking" (reachability requests), or "driving" or "walking" (nearest parking and distance requests). */
+    int maxTime = -1; /**< Travel time budget (reachability requests). */
+    bool parkingOnly = false; /**< Whether only parking locations are reported (reachability requests). */
+    int count = -1; /**< Number of parking locations to find (nearest parking requests). */
+    int departureTime = -1; /**< Departure time in minutes after midnight, -1 for the base travel times (driving and driving-walking requests). */
 } Request;
 
 /**
@@ -28,8 +36,23 @@ typedef struct {
  */
 
 class RequestProcessor {
+private:
+    static OutputSink *output_sink_; /**< Sink set by the front end, nullptr for the default session sink. */
+
 public:
 
+    /**
+    * @brief Sets where the results of processRequest and processBatch are written.
+    * @param sink The sink, or nullptr to use the default session sink (output file and standard output).
+    */
+    static void setOutputSink(OutputSink *sink);
+
+    /**
+    * @brief Gets the sink the results are currently written to.
+    * @return Reference to the current sink.
+    */
+    static OutputSink &getOutputSink();
+
     /**
     * @brief Processes a given request and determines the appropriate routing method.
     * @details O((V + E) log V) for pathfinding operations.
@@ -39,35 +62,131 @@ public:
     */
     static void processRequest(Request &request, RouteNetwork &route_network, int call_mode);
 
+    /**
+    * @brief Processes several requests in one pass, writing all results to the same output.
+    * @details Unrestricted driving requests are grouped by (source, mode) and each group is answered
+    * from a single shortest-path tree, so a batch costs one Dijkstra per distinct source instead of one per request.
+    * The trees of different groups are computed in parallel on the shared thread pool.
+    * @param requests The routing requests, answered in the given order.
+    * @param route_network The target route network.
+    * @param call_mode The mode of call (ID, Code, Name).
+    */
+    static void processBatch(std::vector<Request> &requests, RouteNetwork &route_network, int call_mode);
+
+    /**
+    * @brief Determines the appropriate routing method for a request and computes its result.
+    *
+    * Sets the departure time of the network to the one of the request, so driving searches follow the
+    * time-of-day profiles only for requests with a departure time.
+    *
+    * @param request The routing request.
+    * @param route_network The target route network.
+    * @return The result of the request, with status ROUTE_INVALID if it cannot be processed.
+    */
+    static RouteResult dispatchRequest(Request &request, RouteNetwork &route_network);
+
+    /**
+    * @brief Checks if a request is a driving request without avoided nodes, avoided segments or include node.
+    * @param request The routing request.
+    * @return True if the request is an unrestricted driving request.
+    */
+    static bool isUnrestrictedDriving(const Request &request);
+
+    /**
+    * @brief Creates an empty result for a request.
+    * @param request The routing request.
+    * @param kind One of the RESULT_* kinds.
+    * @return A result with the source, destination and walking limit of the request.
+    */
+    static RouteResult newResult(const Request &request, int kind);
+
+    /**
+    * @brief Gets the request type under which a result is aggregated in the query statistics.
+    * @param result The result of the request.
+    * @return "invalid" for invalid requests, the name of the result kind otherwise.
+    */
+    static std::string getStatsType(const RouteResult &result);
+
     /**
     * @brief Processes a driving route without any restrictions.
     * @details O((V + E) log V) due to Dijkstra’s algorithm.
     * @param request The routing request.
     * @param route_network The target route network.
-    * @param call_mode The mode of call (ID, Code, Name).
-    * @param out Output stream handler.
+    * @return The best and alternative driving routes.
+    */
+    static RouteResult processUnrestrictedDriving(Request &request, RouteNetwork &route_network);
+
+    /**
+    * @brief Processes a driving route without any restrictions whose best route is already known.
+    * @details O((V + E) log V), only the alternative route requires a new search.
+    * @param request The routing request.
+    * @param route_network The target route network.
+    * @param best The best driving route, empty if there is none.
+    * @param best_weight The total driving time of the best route.
+    * @return The best and alternative driving routes.
     */
-    static void processUnrestrictedDriving(Request &request, RouteNetwork &route_network, int call_mode, MultiStream out);
+    static RouteResult processUnrestrictedDriving(Request &request, RouteNetwork &route_network, const std::vector<Location*> &best, double best_weight);
 
     /**
     * @brief Processes a driving route with restrictions (blocked nodes or edges).
     * @details O((V + E) log V), considering blocked nodes and alternative paths.
     * @param request The routing request.
     * @param route_network The target route network.
-    * @param call_mode The mode of call (ID, Code, Name).
-    * @param out Output stream handler.
+    * @return The restricted driving route.
     */
-    static void processRestrictedDriving(Request &request, RouteNetwork &route_network, int call_mode, MultiStream out);
+    static RouteResult processRestrictedDriving(Request &request, RouteNetwork &route_network);
 
     /**
     * @brief Processes a combined driving and walking route.
     * @details O((V + E) log V) for Dijkstra’s calculations.
     * @param request The routing request.
     * @param route_network The target route network.
-    * @param call_mode The mode of call (ID, Code, Name).
-    * @param out Output stream handler.
+    * @return The driving route, parking node and walking route.
+    */
+    static RouteResult processDrivingWalking(Request &request, RouteNetwork &route_network);
+
+    /**
+    * @brief Finds the Pareto-optimal trade-offs between total time and walking time of a driving-walking request.
+    *
+    * Each segment is either driven or walked, so the two times of a route only depend on its parking location:
+    * one walking search from the destination and one driving search from the source give both for every parking
+    * location, and the options are the ones no other parking location beats on both. When there are more than
+    * MAX_PARETO_OPTIONS, the fastest, the least walking and evenly spaced ones in between are kept.
+    *
+    * @details O((V + E) log V) for the two searches, plus O(P log P) for the P parking locations within the walking limit.
+    * @param request The routing request.
+    * @param route_network The target route network.
+    * @return The options by increasing total time, each with its driving route, parking node and walking route.
+    */
+    static RouteResult processDrivingWalkingPareto(Request &request, RouteNetwork &route_network);
+
+    /**
+    * @brief Finds every location reachable from the source within the time budget.
+    * @details O((V' + E') log V') for the V' locations and E' segments within the budget, using bounded searches.
+    * In driving-walking mode the budget covers driving to any parking location and walking from there.
+    * @param request The reachability request.
+    * @param route_network The target route network.
+    * @return The reachable locations, by increasing travel time.
+    */
+    static RouteResult processReachability(Request &request, RouteNetwork &route_network);
+
+    /**
+    * @brief Finds the parking locations closest to the source.
+    * @details O((V' + E') log V') for the V' locations and E' segments closer than the last parking location found.
+    * @param request The nearest parking request.
+    * @param route_network The target route network.
+    * @return The parking locations, by increasing travel time.
+    */
+    static RouteResult processNearestParking(Request &request, RouteNetwork &route_network);
+
+    /**
+    * @brief Finds the travel time between two locations, without the route.
+    * @details O(L) for labels of L hubs when the network has hub labels, O((V + E) log V) otherwise.
+    * @param request The distance request.
+    * @param route_network The target route network.
+    * @return The travel time, not found if the destination cannot be reached.
     */
-    static void processDrivingWalking(Request &request, RouteNetwork &route_network, int call_mode, MultiStream out);
+    static RouteResult processDistance(Request &request, RouteNetwork &route_network);
 };
 
 
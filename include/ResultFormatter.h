@@ -0,0 +1,112 @@
+#ifndef RESULTFORMATTER_H
+#define RESULTFORMATTER_H
+
+#include <cstdint>
+#include <string>
+
+#include "OutputSink.h"
+#include "RouteNetwork.h"
+#include "RouteResult.h"
+
+/**
+ * @class ResultFormatter
+ * @brief Writes route results to an output sink as text, JSON Lines or binary records.
+ *
+ * The binary record of a result, in host byte order, is:
+ * uint32 size of the rest of the record, uint8 kind, uint8 status, int32 source, int32 destination,
+ * then the route, alternative and walking paths, each as uint32 count, count x int32 location IDs and float64 weight,
+ * and finally int32 parking node, float64 total time (the travel time of a distance result) and int32 departure time.
+ */
+class ResultFormatter {
+private:
+    /**
+    * @brief Writes the label of a location according to the call mode.
+    * @param id The location ID.
+    * @param route_network The network the location belongs to.
+    * @param call_mode The mode used for displaying location information (ID, Code, or Name).
+    * @param out The output sink.
+    */
+    static void writeLocation(int id, RouteNetwork &route_network, int call_mode, OutputSink &out);
+
+    /**
+    * @brief Writes a path as comma separated locations followed by its weight, or "none".
+    * @param path The path to write.
+    * @param route_network The network the path belongs to.
+    * @param call_mode The mode used for displaying location information (ID, Code, or Name).
+    * @param out The output sink.
+    */
+    static void writeTextPath(const PathResult &path, RouteNetwork &route_network, int call_mode, OutputSink &out);
+
+    /**
+    * @brief Writes a path as a JSON object, or null if there is no path.
+    * @param path The path to write.
+    * @param out The output sink.
+    */
+    static void writeJsonPath(const PathResult &path, OutputSink &out);
+
+    /**
+    * @brief Escapes a string for use inside a JSON string literal.
+    * @param text The text to escape.
+    * @return The escaped text.
+    */
+    static std::string escapeJson(const std::string &text);
+
+    /**
+    * @brief Appends a value to a binary record in host byte order.
+    * @tparam T Type of the value.
+    * @param record The record being built.
+    * @param value The value to append.
+    */
+    template <typename T>
+    static void appendBinary(std::string &record, T value) {
+        record.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+public:
+    /**
+    * @brief Gets the name of a result kind, as used in JSON output and query statistics.
+    * @param kind One of the RESULT_* kinds.
+    * @return The kind name (e.g. "driving-walking").
+    */
+    static const char *getKindName(int kind);
+
+    /**
+    * @brief Writes a result in the format selected in the sink.
+    * @param result The result to write.
+    * @param route_network The network the result refers to.
+    * @param call_mode The mode used for displaying location information in text (ID, Code, or Name).
+    * @param out The output sink.
+    */
+    static void write(const RouteResult &result, RouteNetwork &route_network, int call_mode, OutputSink &out);
+
+    /**
+    * @brief Writes a result in the text format of the output examples.
+    * @param result The result to write.
+    * @param route_network The network the result refers to.
+    * @param call_mode The mode used for displaying location information (ID, Code, or Name).
+    * @param out The output sink.
+    */
+    static void writeText(const RouteResult &result, RouteNetwork &route_network, int call_mode, OutputSink &out);
+
+    /**
+    * @brief Writes a result as a single line JSON object, with locations given by ID.
+    * @param result The result to write.
+    * @param out The output sink.
+    */
+    static void writeJsonLine(const RouteResult &result, OutputSink &out);
+
+    /**
+    * @brief Writes a result as a length-prefixed binary record, with locations given by ID.
+    *
+    * Every record has the departure time in minutes after midnight (int32, -1 if none) after the total time.
+    * Reachability and nearest parking records end with the number of locations found and an (int32 ID, double time) pair for each.
+    * Pareto records end with the number of options and, for each, its driving and walking paths (as above),
+    * int32 parking node and float64 total time.
+    *
+    * @param result The result to write.
+    * @param out The output sink.
+    */
+    static void writeBinary(const RouteResult &result, OutputSink &out);
+};
+
+#endif //RESULTFORMATTER_H
@@ -8,16 +8,10 @@
 * @class Route
 * @brief Represents a route between two locations, extending the Edge class.
 *
-* This class models a route with attributes for walking and driving times, as well as
-* the origin and destination locations.
+* The walking and driving times and the origin and destination are those stored by the Edge,
+* this class only adds accessors by location code.
 */
 class Route : public Edge<std::string> {
-private:
-    double walking_time_; /**< Time required to traverse the route by walking. */
-    double driving_time_; /**< Time required to traverse the route by driving. */
-    std::string orig_; /**< Origin location identifier. */
-    std::string dest_; /**< Destination location identifier. */
-
 public:
     /**
     * @brief Constructs a Route object.
@@ -25,8 +19,9 @@ public:
     * @param dest Pointer to the destination vertex.
     * @param walking_time The time needed to walk along this route.
     * @param driving_time The time needed to drive along this route.
+    * @param id The segment id of the route.
     */
-    Route(Vertex<std::string>* orig, Vertex<std::string>* dest, double walking_time, double driving_time);
+    Route(Vertex<std::string>* orig, Vertex<std::string>* dest, double walking_time, double driving_time, unsigned id);
 
     /**
     * @brief Gets the walking time for this route.
@@ -1,10 +1,21 @@
 #ifndef ROUTENETWORK_H
 #define ROUTENETWORK_H
 
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
 #include <unordered_map>
 #include <unordered_set>
+#include "CustomizableHierarchy.h"
+#include "DeltaStepping.h"
 #include "Graph.h"
+#include "HubLabels.h"
 #include "Location.h"
+#include "NodeOrdering.h"
+#include "RoutingGraph.h"
+#include "SeparationIndex.h"
+#include "TravelTimeProfiles.h"
 
 #define ID_MODE 0 /**< @brief Mode for using ID in location  */
 #define CODE_MODE 1 /**< @brief Mode for using Code in location lookup */
@@ -26,8 +37,45 @@ private:
     RouteNetwork *route_network_; /**< Pointer to the route network instance. */
     std::unordered_map<std::string ,Location*>* locations_; /**< Stores locations mapped by their identifiers. */
 
-    std::unordered_set<Vertex<std::string>*> blockedNodes; /**< Set of blocked nodes in the network. */
-    std::unordered_set<Edge<std::string>*> blockedEdges;  /**< Set of blocked edges in the network. */
+    RoutingGraph routing_graph_; /**< Compact copy of the network searched by PathFinding. */
+    std::vector<Location*> nodes_; /**< Location of each routing graph node. */
+    std::unordered_map<int, uint32_t> node_by_id_; /**< Routing graph node of each external location ID. */
+    std::vector<char> parking_; /**< Whether each routing graph node has parking. */
+    int node_order_ = ORDER_INPUT; /**< One of the ORDER_* node orders used when building the routing graph. */
+    std::vector<uint32_t> components_[2]; /**< Component of each node, indexed by WALKING_MODE or DRIVING_MODE. */
+    SeparationIndex driving_separation_; /**< Articulation points and bridges of the driving network. */
+    bool driving_stale_ = false; /**< Whether a segment became drivable or undrivable since the driving components were labelled. */
+    std::string profile_file_; /**< Time-of-day profile file read by parseData, empty for constant driving times. */
+    TravelTimeProfiles profiles_; /**< Driving profiles shared by the segments. */
+    std::vector<uint16_t> segment_profiles_; /**< Profile of each graph segment id, as read from the route file. */
+    bool use_hierarchy_ = false; /**< Whether unrestricted searches use the customizable hierarchy. */
+    bool hierarchy_stale_ = false; /**< Whether a segment changed since the hierarchy was customized. */
+    CustomizableHierarchy hierarchy_; /**< Customizable contraction hierarchy, built only if use_hierarchy_ is set. */
+    bool use_hub_labels_ = false; /**< Whether travel time queries use the hub labels. */
+    bool labels_stale_ = false; /**< Whether a segment changed since the hub labels were built. */
+    std::string label_file_; /**< File the hub labels are read from and saved to, empty to always build them. */
+    HubLabels hub_labels_; /**< Hub labels of both travel modes, built only if use_hub_labels_ is set. */
+    DeltaStepping delta_stepping_; /**< Multithreaded engine of the one-to-all searches, used with more than one search thread. */
+
+    uint64_t serial_; /**< Number of the network, never reused, so a thread's cached context cannot outlive its network. */
+    std::mutex contexts_mutex_; /**< Guards contexts_. */
+    std::unordered_map<std::thread::id, std::unique_ptr<SearchContext>> contexts_; /**< Search context of each thread that searched the network. */
+
+    static std::atomic<uint64_t> next_serial_; /**< Serial of the next network constructed. */
+    static thread_local uint64_t cached_network_; /**< Serial of the network whose context the calling thread last used, 0 for none. */
+    static thread_local SearchContext *cached_context_; /**< Context of the calling thread in that network. */
+
+    /**
+    * @brief Finds or creates the search context of the calling thread, and caches it.
+    * @return The context.
+    */
+    SearchContext& findSearchContext();
+
+    /**
+    * @brief Sizes the blocked node and segment flags of a context for the routing graph and drops its trees.
+    * @param context The context.
+    */
+    void resetSearchContext(SearchContext &context);
 
     /**
     * @brief Parses a location data file and loads location data.
@@ -38,11 +86,46 @@ private:
 
     /**
      * @brief Parses a route data file and loads route data.
+     *
+     * An optional fifth column gives the ID of the time-of-day profile of the driving time. Profiles that are
+     * unknown, or that would let a later departure arrive earlier on the segment, are reported and ignored.
+     *
      * @param route_file The path to the route file.
      * @return True if parsing was successful, false otherwise.
      */
     bool parseRoute(const std::string& route_file);
 
+    /**
+     * @brief Rebuilds the routing graph from the locations and routes, numbering nodes in the selected order.
+     */
+    void buildRoutingGraph();
+
+    /**
+     * @brief Sets the travel times of every segment between two locations, in the graph and the routing graph.
+     *
+     * Marks the hierarchy and the hub labels as stale, and the driving components too when a segment changes between
+     * drivable and undrivable, the only change they depend on; walking times are always finite.
+     * A profile that would no longer be first-in first-out with the new driving time is dropped.
+     *
+     * @details **Time Complexity** O(deg(l1))
+     * @param l1 One endpoint of the segments.
+     * @param l2 The other endpoint.
+     * @param walking_time The new walking time.
+     * @param driving_time The new driving time (INT_MAX if the segments cannot be driven).
+     * @return True if there is at least one segment between the locations, false otherwise.
+     */
+    bool setSegmentTimes(Location* l1, Location* l2, double walking_time, double driving_time);
+
+    /**
+     * @brief Recomputes what depends on the segment times and is stale: the driving components and separation
+     * index, and the hierarchy weights, as separate tasks of the shared thread pool, then the hub labels.
+     *
+     * Freshly built labels are saved to the label file, if there is one.
+     *
+     * @details **Time Complexity** O(V+E) for the driving connectivity, O(T) for the customization and O(V·L²) for the labels, each only when stale
+     */
+    void refreshDerivedData();
+
 public:
     /**
      * @brief Constructs a new RouteNetwork object.
@@ -55,13 +138,168 @@ public:
     ~RouteNetwork();
 
     /**
-     * @brief Parses location and route data from files.
+     * @brief Parses location and route data from files, and the profile file if one was selected.
      * @param location_data Path to the location data file.
      * @param route_data Path to the route data file.
-     * @return True if both files were successfully parsed, false otherwise.
+     * @return True if every file was successfully parsed, false otherwise.
      */
     bool parseData(const std::string& location_data, const std::string& route_data);
 
+    /**
+     * @brief Changes the travel times of the segments between two locations in place.
+     *
+     * Searches must not run while the times change; the query server takes its network lock.
+     *
+     * @details **Time Complexity** O(deg), plus O(V+E) if the segments become drivable or undrivable and the customization if the hierarchy is used
+     * @param id1 The ID of one endpoint.
+     * @param id2 The ID of the other endpoint.
+     * @param walking_time The new walking time.
+     * @param driving_time The new driving time (INT_MAX if the segments cannot be driven).
+     * @return True if there is at least one segment between the locations, false otherwise.
+     */
+    bool updateSegment(int id1, int id2, double walking_time, double driving_time);
+
+    /**
+     * @brief Applies a file of travel time updates without reloading the network.
+     *
+     * The file has the columns of the route file (Location1,Location2,Driving,Walking, with a header line
+     * and X for segments that cannot be driven), listing only the segments that changed, with their new times.
+     * Rows naming unknown locations or segments, or with invalid times, are skipped. The driving components
+     * are relabelled at most once per file, and only if a segment became drivable or undrivable; the hierarchy, if
+     * used, is customized once per file.
+     * Searches must not run while the updates are applied; the query server takes its network lock.
+     *
+     * @details **Time Complexity** O(U·deg) for U rows, plus O(V+E) if drivability changed and one customization if the hierarchy is used
+     * @param update_file The path to the update file.
+     * @return The number of rows applied, or -1 if the file cannot be read.
+     */
+    int applyUpdates(const std::string& update_file);
+
+    /**
+     * @brief Selects how routing graph nodes are numbered, taking effect on the next parseData.
+     *
+     * Location IDs, codes and names are unaffected. Routes of equal length may be chosen differently
+     * under different orders, since the searches break ties by node index.
+     *
+     * @param order One of the ORDER_* node orders.
+     */
+    void setNodeOrder(int order);
+
+    /**
+     * @brief Selects the time-of-day profile file read by the next parseData.
+     *
+     * Its Profile,Time,Factor rows are referenced by the fifth column of the route file (see TravelTimeProfiles).
+     *
+     * @param profile_file The path to the profile file, empty for constant driving times.
+     */
+    void setProfileFile(const std::string& profile_file);
+
+    /**
+     * @brief Gets the time-of-day driving profiles.
+     * @return The profiles.
+     */
+    const TravelTimeProfiles& getProfiles() const { return profiles_; }
+
+    /**
+     * @brief Sets the departure time of the next driving searches of the calling thread.
+     *
+     * Requests set it before searching.
+     *
+     * @param minutes Minutes after midnight, -1 for the base travel times.
+     */
+    void setDepartureTime(double minutes);
+
+    /**
+     * @brief Gets the departure time of the driving searches.
+     * @return Minutes after midnight, -1 for the base travel times.
+     */
+    double getDepartureTime() { return getSearchContext().departureTime; }
+
+    /**
+     * @brief Checks if driving searches follow the time-of-day profiles.
+     * @return True if a departure time is set and some segment has a profile.
+     */
+    bool isTimeDependent() { return getSearchContext().departureTime >= 0 && routing_graph_.hasProfiles(); }
+
+    /**
+     * @brief Selects whether unrestricted searches use a customizable contraction hierarchy, taking effect on the next parseData.
+     *
+     * The hierarchy is built once per network and customized again after travel time updates. Searches with
+     * blocked nodes or segments still use Dijkstra's algorithm. Routes of equal length may be chosen differently.
+     *
+     * @param enabled True to build and use the hierarchy.
+     */
+    void setHierarchy(bool enabled);
+
+    /**
+     * @brief Checks if unrestricted searches use the customizable hierarchy.
+     * @return True if the hierarchy is built and used.
+     */
+    bool usesHierarchy() const { return use_hierarchy_; }
+
+    /**
+     * @brief Gets the customizable hierarchy, only built if usesHierarchy() is true.
+     * @return The hierarchy.
+     */
+    CustomizableHierarchy& getHierarchy();
+
+    /**
+     * @brief Selects whether travel time queries use hub labels, taking effect when the data is next parsed.
+     *
+     * The labels are read from the label file when it holds labels of the same graph and weights, and built
+     * from a customizable hierarchy and saved to it otherwise. They are built again after travel time updates.
+     * Queries with blocked nodes or segments, or with a departure time, still search.
+     *
+     * @param enabled True to use hub labels.
+     * @param label_file (Optional) File to read the labels from and save them to.
+     */
+    void setHubLabels(bool enabled, const std::string &label_file = "");
+
+    /**
+     * @brief Checks if travel time queries use hub labels.
+     * @return True if the hub labels are built and used.
+     */
+    bool usesHubLabels() const { return use_hub_labels_; }
+
+    /**
+     * @brief Gets the hub labels, only built if usesHubLabels() is true.
+     * @return The hub labels.
+     */
+    const HubLabels& getHubLabels() const { return hub_labels_; }
+
+    /**
+     * @brief Computes the travel time between two locations, without the route.
+     * @details **Time Complexity** O(L) with hub labels of L entries, O((V+E)logV) otherwise
+     * @param src The source location ID.
+     * @param dest The destination location ID.
+     * @param mode Boolean flag indicating whether to use driving mode (true) or walking mode (false).
+     * @return The travel time, INT_MAX if dest cannot be reached, -1 if a location does not exist.
+     */
+    double getTravelTime(int src, int dest, bool mode);
+
+    /**
+     * @brief Selects how many threads each one-to-all search uses.
+     *
+     * With more than one thread, searches with the base travel times run delta-stepping (see DeltaStepping)
+     * instead of Dijkstra's algorithm. Distances are the same; routes of equal length may be chosen differently.
+     *
+     * @param threads Number of threads, 1 for Dijkstra's algorithm.
+     * @param delta Bucket width in minutes, 0 to use the mean segment weight of the searched mode.
+     */
+    void setSearchThreads(int threads, double delta = 0);
+
+    /**
+     * @brief Gets the number of threads of each one-to-all search.
+     * @return The number of threads, 1 for Dijkstra's algorithm.
+     */
+    int getSearchThreads() const { return delta_stepping_.getThreads(); }
+
+    /**
+     * @brief Gets the multithreaded search engine.
+     * @return The delta-stepping engine.
+     */
+    DeltaStepping& getDeltaStepping();
+
     /**
      * @brief Retrieves the locations stored in an unordered map data structure .
      * @return Pointer to the unordered map of locations.
@@ -76,12 +314,55 @@ public:
 
     /**
      * @brief Retrieves all location vertices in the network.
-     * @return A vector of location vertices.
+     * @return A view of the location vertices, in the order of the locations file.
      */
-    std::vector<Vertex<std::string>*> getLocationSet();
+    Span<Vertex<std::string>*> getLocationSet() const;
+
+    /**
+    * @brief Gets the routing graph searched by PathFinding.
+    * @return The routing graph.
+    */
+    const RoutingGraph& getRoutingGraph() const;
+
+    /**
+    * @brief Gets the search context of the calling thread.
+    *
+    * Each thread that searches the network gets a context of its own on first use, kept between requests so its
+    * arrays are not reallocated: requests on different threads never share search arrays, blocked nodes and
+    * segments or departure times, and may run at the same time as long as nothing changes the network itself.
+    *
+    * @return The context.
+    */
+    SearchContext& getSearchContext() { return cached_network_ == serial_ ? *cached_context_ : findSearchContext(); }
+
+    /**
+    * @brief Gets the arrays of the last search run on the network by the calling thread.
+    * @return The search state.
+    */
+    SearchState& getSearchState() { return getSearchContext().search; }
+
+    /**
+    * @brief Gets the tree without blocked nodes or segments that the last search of the calling thread was repaired from.
+    * @return The search state, whose source is NO_NODE if there is none.
+    */
+    SearchState& getBaseSearchState() { return getSearchContext().base; }
+
+    /**
+    * @brief Gets the arrays of the bounded searches run on the network by the calling thread.
+    * @return The bounded search state.
+    */
+    BoundedSearchState& getBoundedSearchState() { return getSearchContext().bounded; }
+
+    /**
+    * @brief Gets the location of a routing graph node.
+    * @param index The node index.
+    * @return Pointer to the Location object.
+    */
+    Location* getLocationByIndex(uint32_t index);
 
     /**
     * @brief Finds a location by its numeric ID.
+    * @details **Time Complexity** O(1) on average
     * @param id The location ID.
     * @return Pointer to the Location object or nullptr if not found.
     */
@@ -102,13 +383,65 @@ public:
     Location* getLocationByName(const std::string& name);
 
     /**
-     * @brief Blocks a specific node in the network and adds it to an unordered set structure.
+     * @brief Finds the parking locations closest to a location.
+     *
+     * Runs a search from the location that stops as soon as k parking locations are reached, so the
+     * cost depends on how far the k-th parking location is rather than on the size of the network.
+     *
+     * @details **Time Complexity** O((V'+E')logV') for the V' locations and E' segments closer than the k-th parking location
+     * @param id The ID of the location.
+     * @param k Number of parking locations to find.
+     * @param mode DRIVING_MODE or WALKING_MODE.
+     * @return Up to k parking locations with their travel times, closest first (empty if the location does not exist).
+     */
+    std::vector<std::pair<Location*, double>> findNearestParking(int id, int k, bool mode);
+
+    /**
+     * @brief Checks if two locations are in the same component of a travel mode.
+     *
+     * Blocked nodes and segments are not taken into account, so a false answer means no search
+     * can find a route between the locations, whatever is avoided.
+     *
+     * @details **Time Complexity** O(1) on average
+     * @param id1 The ID of the first location.
+     * @param id2 The ID of the second location.
+     * @param mode DRIVING_MODE or WALKING_MODE.
+     * @return True if both locations exist and are connected, false otherwise.
+     */
+    bool areConnected(int id1, int id2, bool mode);
+
+    /**
+     * @brief Checks if two routing graph nodes are in the same component of a travel mode.
+     * @param u The first node index.
+     * @param v The second node index.
+     * @param mode DRIVING_MODE or WALKING_MODE.
+     * @return True if the nodes are connected, false otherwise.
+     */
+    bool sameComponent(uint32_t u, uint32_t v, bool mode) const { return components_[mode][u] == components_[mode][v]; }
+
+    /**
+     * @brief Checks if one of the avoided nodes or segments, on its own, cuts every driving route between two locations.
+     *
+     * Avoiding the source also counts, since the search cannot leave it. Sets that only separate the
+     * locations when taken together are not detected, so a false answer still needs a search.
+     *
+     * @details **Time Complexity** O(k log V) for k avoided nodes and segments
+     * @param src The ID of the source location.
+     * @param dest The ID of the destination location, connected to the source when driving.
+     * @param avoid_nodes IDs of the locations to avoid.
+     * @param avoid_segments Pairs of IDs of the segments to avoid.
+     * @return True if the request can have no route.
+     */
+    bool avoidSeparates(int src, int dest, const std::vector<int> &avoid_nodes, const std::vector<std::pair<int, int>> &avoid_segments);
+
+    /**
+     * @brief Blocks a specific node in the network, for the searches of the calling thread.
      * @param node The ID of the node to block.
      */
     void blockNode(int node);
 
     /**
-     * @brief Blocks an edge between two locations and adds it to an unordered set structure.
+     * @brief Blocks both directions of the segments between two locations, for the searches of the calling thread.
      * @param a First location ID.
      * @param b Second location ID.
      */
@@ -116,20 +449,44 @@ public:
 
     /**
      * @brief Checks if a node is blocked.
-     * @param v The vertex to check.
+     * @param index The routing graph node index.
      * @return True if the node is blocked, false otherwise.
      */
-    bool isNodeBlocked(Vertex<std::string>* v);
+    bool isNodeBlocked(uint32_t index) { return getSearchContext().blockedNodes[index]; }
+
+    /**
+     * @brief Checks if a segment is blocked.
+     * @param segment The segment id (RoutingArc::segment).
+     * @return True if the segment is blocked, false otherwise.
+     */
+    bool isSegmentBlocked(uint32_t segment) { return getSearchContext().blockedSegments[segment]; }
+
+    /**
+     * @brief Gets the blocked nodes, in blocking order.
+     * @return A view of the routing graph node indices, invalidated by blocking or clearing.
+     */
+    Span<uint32_t> getBlockedNodeList() { return getSearchContext().blockedNodeList; }
+
+    /**
+     * @brief Gets one arc of each blocked segment, in blocking order.
+     * @return A view of the arc indices, invalidated by blocking or clearing.
+     */
+    Span<uint32_t> getBlockedSegmentList() { return getSearchContext().blockedSegmentList; }
 
     /**
-     * @brief Checks if an edge is blocked.
-     * @param e The edge to check.
-     * @return True if the edge is blocked, false otherwise.
+     * @brief Checks if any node or segment is blocked.
+     * @return True if a node or segment is blocked, false otherwise.
      */
-    bool isEdgeBlocked(Edge<std::string>* e);
+    bool hasBlocked() {
+        SearchContext &context = getSearchContext();
+        return !context.blockedNodeList.empty() || !context.blockedSegmentList.empty();
+    }
 
     /**
-     * @brief Clears all blocked nodes and edges from the unordered set structures.
+     * @brief Clears all blocked nodes and edges of the calling thread.
+     *
+     * A search tree that took blocked nodes or segments into account is dropped; the tree it was repaired
+     * from stays available as the base search state.
      */
     void clearBlocked();
 
@@ -0,0 +1,72 @@
+#ifndef ROUTERESULT_H
+#define ROUTERESULT_H
+
+#include <string>
+#include <vector>
+
+#define RESULT_UNRESTRICTED_DRIVING 0 /**< @brief Best and alternative driving routes */
+#define RESULT_RESTRICTED_DRIVING 1 /**< @brief Driving route avoiding nodes/segments or through an include node */
+#define RESULT_DRIVING_WALKING 2 /**< @brief Driving route to a parking node followed by a walking route */
+#define RESULT_REACHABILITY 3 /**< @brief Locations reachable from the source within a time budget */
+#define RESULT_NEAREST_PARKING 4 /**< @brief Parking locations closest to the source */
+#define RESULT_PARETO 5 /**< @brief Driving-walking options trading total time against walking time */
+#define RESULT_DISTANCE 6 /**< @brief Travel time between two locations, without the route */
+
+#define ROUTE_OK 0 /**< @brief The requested route was found */
+#define ROUTE_NOT_FOUND 1 /**< @brief No route satisfies the request */
+#define ROUTE_INVALID 2 /**< @brief The request could not be processed (see message) */
+
+/**
+ * @struct PathResult
+ * @brief A path given by the IDs of its locations, from origin to destination, and its total weight.
+ */
+typedef struct {
+    std::vector<int> path; /**< Location IDs of the path, empty if there is no path. */
+    double weight = 0; /**< Total driving or walking time of the path. */
+} PathResult;
+
+/**
+ * @struct ReachedLocation
+ * @brief A location within the budget of a reachability request.
+ */
+typedef struct {
+    int id; /**< Location ID. */
+    double time; /**< Shortest travel time from the source. */
+} ReachedLocation;
+
+/**
+ * @struct RouteOption
+ * @brief One way of driving to a parking location and walking from there to the destination.
+ */
+typedef struct {
+    PathResult driving; /**< Driving route to the parking location. */
+    int parkingNode = -1; /**< Parking location ID. */
+    PathResult walking; /**< Walking route from the parking location. */
+    double totalTime = 0; /**< Driving plus walking time. */
+} RouteOption;
+
+/**
+ * @struct RouteResult
+ * @brief Outcome of a routing request, independent of how it is written.
+ */
+typedef struct {
+    int kind = RESULT_UNRESTRICTED_DRIVING; /**< One of the RESULT_* kinds. */
+    int status = ROUTE_OK; /**< One of the ROUTE_* statuses. */
+    int src = -1; /**< Source location ID. */
+    int dest = -1; /**< Destination location ID. */
+    PathResult route; /**< Best, restricted or driving route, depending on the kind. */
+    PathResult alternative; /**< Alternative driving route (unrestricted driving only). */
+    PathResult walking; /**< Walking route from the parking node (driving-walking only). */
+    int parkingNode = -1; /**< Parking location ID (driving-walking only). */
+    double totalTime = 0; /**< Driving plus walking time (driving-walking), or the travel time (distance). */
+    int maxWalkTime = -1; /**< Maximum allowed walking time of the request. */
+    std::string travelMode; /**< Travel mode of a reachability, nearest parking or distance request. */
+    int maxTime = -1; /**< Time budget of a reachability request. */
+    int count = -1; /**< Number of parking locations asked by a nearest parking request. */
+    int departureTime = -1; /**< Departure time of a time-dependent request in minutes after midnight, -1 otherwise. */
+    std::vector<RouteOption> options; /**< Pareto-optimal options by increasing total time, so by decreasing walking time (Pareto only). */
+    std::vector<ReachedLocation> reached; /**< Reachable or nearest parking locations by increasing time (reachability and nearest parking only). */
+    std::string message; /**< Explanation when the status is not ROUTE_OK. */
+} RouteResult;
+
+#endif //ROUTERESULT_H
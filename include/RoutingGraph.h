@@ -0,0 +1,228 @@
+#ifndef ROUTINGGRAPH_H
+#define ROUTINGGRAPH_H
+
+#include <cstdint>
+#include <vector>
+
+#include "TravelTimeProfiles.h"
+
+#define NO_NODE UINT32_MAX /**< @brief Node index meaning "no node" (e.g. the parent of a search source) */
+
+/**
+ * @struct RoutingArc
+ * @brief One direction of a segment, as stored for routing.
+ */
+typedef struct {
+    uint32_t target; /**< Index of the node the arc leads to. */
+    uint32_t segment; /**< Segment the arc belongs to, shared by both directions of an undirected segment. */
+} RoutingArc;
+
+/**
+ * @struct SegmentWeights
+ * @brief Travel times of a segment, stored once for both of its directions.
+ */
+typedef struct {
+    float walking; /**< Walking time, in minutes. */
+    float driving; /**< Driving time, in minutes (INT_MAX when the segment cannot be driven). */
+} SegmentWeights;
+
+/**
+ * @struct SearchState
+ * @brief Per-search arrays of a shortest path search, indexed by node, and what the resulting tree was computed for.
+ *
+ * The tree stays valid while the network only gains blocked nodes and segments, so a later search from the
+ * same source can repair it instead of starting over.
+ */
+typedef struct {
+    std::vector<double> dist; /**< Distance from the source, INT_MAX if not reached. */
+    std::vector<uint32_t> parent; /**< Previous node in the shortest path, NO_NODE for the source and unreached nodes. */
+    std::vector<uint32_t> parentArc; /**< Arc from the parent, NO_NODE if there is no parent. */
+    std::vector<uint32_t> heapPos; /**< Heap position of each node during a repair, 0 otherwise. */
+    uint32_t source = NO_NODE; /**< Source node of the tree, NO_NODE if the arrays hold no valid tree. */
+    double departure = -1; /**< Departure time of a time-dependent tree in minutes after midnight, -1 for the base travel times. */
+    bool isDriving = false; /**< Travel mode of the tree. */
+    uint32_t blockedNodes = 0; /**< Number of entries of the blocked node list the tree accounts for. */
+    uint32_t blockedSegments = 0; /**< Number of entries of the blocked segment list the tree accounts for. */
+} SearchState;
+
+/**
+ * @struct BoundedSearchState
+ * @brief Arrays of the bounded searches, kept between searches so that each one only resets what the previous one touched.
+ */
+typedef struct {
+    std::vector<double> dist; /**< Distance from the sources, INT_MAX if not reached. */
+    std::vector<uint32_t> heapPos; /**< Heap position of each node, 0 outside a search. */
+    std::vector<uint32_t> touched; /**< Nodes reached by the last search. */
+} BoundedSearchState;
+
+/**
+ * @struct HierarchySearchState
+ * @brief Arrays of the customizable hierarchy queries, indexed by rank, left reset after each query.
+ */
+typedef struct {
+    std::vector<double> dist[2]; /**< Query distances, from the source (0) and the target (1). */
+    std::vector<uint32_t> pred[2]; /**< Edge that set each query distance, from the source (0) and the target (1). */
+} HierarchySearchState;
+
+/**
+ * @struct SearchContext
+ * @brief Everything a request changes on the network while it is answered, kept per thread so requests can run at the same time.
+ */
+typedef struct {
+    SearchState search; /**< Arrays of the last search run by the thread. */
+    SearchState base; /**< Tree without blocked nodes or segments, saved before search is repaired. */
+    BoundedSearchState bounded; /**< Arrays of the bounded searches. */
+    HierarchySearchState hierarchy; /**< Arrays of the hierarchy queries. */
+    std::vector<char> blockedNodes; /**< Whether each node is blocked. */
+    std::vector<char> blockedSegments; /**< Whether each segment is blocked, in both directions. */
+    std::vector<uint32_t> blockedNodeList; /**< Blocked nodes, so clearing does not scan every node. */
+    std::vector<uint32_t> blockedSegmentList; /**< An arc of each blocked segment, in blocking order, so clearing does not scan every segment. */
+    double departureTime = -1; /**< Departure time of the driving searches in minutes after midnight, -1 for the base travel times. */
+} SearchContext;
+
+/**
+ * @class RoutingGraph
+ * @brief Compact adjacency-array (CSR) copy of the network used by the searches.
+ *
+ * Nodes are numbered 0..n-1 and the arcs of node u are the indices firstArc(u) to endArc(u)-1,
+ * in the same order as the outgoing edges of the corresponding vertex.
+ * Weights are kept per segment (the graph's edge id), so both arcs of an undirected segment share them.
+ * Search scratch (distances, parents, heap positions) is not stored here but in per-search arrays.
+ */
+class RoutingGraph {
+private:
+    std::vector<uint32_t> first_ = {0}; /**< first_[u] is the first arc of node u, first_[n] the number of arcs. */
+    std::vector<RoutingArc> arcs_; /**< Arcs grouped by their source node. */
+    std::vector<SegmentWeights> segments_; /**< Weights of each segment, indexed by segment id. */
+    std::vector<uint16_t> profiles_; /**< Driving profile of each segment, empty if no segment has one. */
+
+public:
+    /**
+    * @brief Removes every node and arc.
+    */
+    void clear();
+
+    /**
+    * @brief Adds a node without arcs.
+    * @return The index of the node.
+    */
+    uint32_t addNode();
+
+    /**
+    * @brief Adds an arc leaving the last added node.
+    * @param target Index of the node the arc leads to.
+    * @param segment Segment id of the arc.
+    */
+    void addArc(uint32_t target, uint32_t segment);
+
+    /**
+    * @brief Sets the weights of a segment, growing the segment table if needed.
+    * @param segment The segment id.
+    * @param walking Walking time.
+    * @param driving Driving time.
+    */
+    void setSegment(uint32_t segment, double walking, double driving);
+
+    /**
+    * @brief Sets the time-of-day driving profile of a segment.
+    * @param segment The segment id, whose weights are already set.
+    * @param profile The profile index, NO_PROFILE for a constant driving time.
+    */
+    void setProfile(uint32_t segment, uint16_t profile);
+
+    /**
+    * @brief Builds a copy of the graph with the nodes renumbered.
+    *
+    * The arcs of each node keep their order. Segments are renumbered in order of first use,
+    * so the weights and profiles read by a search follow the new node order as well.
+    *
+    * @param order order[i] is the index in this graph of the node that becomes node i.
+    * @return The renumbered graph.
+    */
+    RoutingGraph permuted(const std::vector<uint32_t> &order) const;
+
+    /**
+    * @brief Checks if any segment has a driving profile.
+    * @return True if driving times depend on the time of day.
+    */
+    bool hasProfiles() const { return !profiles_.empty(); }
+
+    /**
+    * @brief Gets the number of nodes.
+    * @return The number of nodes.
+    */
+    uint32_t getNumNodes() const { return first_.size() - 1; }
+
+    /**
+    * @brief Gets the number of arcs.
+    * @return The number of arcs.
+    */
+    uint32_t getNumArcs() const { return arcs_.size(); }
+
+    /**
+    * @brief Gets the number of segments.
+    * @return The number of segments.
+    */
+    uint32_t getNumSegments() const { return segments_.size(); }
+
+    /**
+    * @brief Gets the index of the first arc leaving a node.
+    * @param u The node index.
+    * @return The arc index.
+    */
+    uint32_t firstArc(uint32_t u) const { return first_[u]; }
+
+    /**
+    * @brief Gets the index after the last arc leaving a node.
+    * @param u The node index.
+    * @return The arc index.
+    */
+    uint32_t endArc(uint32_t u) const { return first_[u + 1]; }
+
+    /**
+    * @brief Gets the node an arc leaves from.
+    * @details **Time Complexity** O(log V)
+    * @param a The arc index.
+    * @return The node index.
+    */
+    uint32_t arcSource(uint32_t a) const;
+
+    /**
+    * @brief Gets an arc.
+    * @param a The arc index.
+    * @return The arc.
+    */
+    const RoutingArc &getArc(uint32_t a) const { return arcs_[a]; }
+
+    /**
+    * @brief Gets the arc array, for kernels that read the arcs of a node as one block.
+    * @return Pointer to arc 0.
+    */
+    const RoutingArc *getArcData() const { return arcs_.data(); }
+
+    /**
+    * @brief Gets the segment weight array, indexed by segment id.
+    * @return Pointer to the weights of segment 0.
+    */
+    const SegmentWeights *getSegmentData() const { return segments_.data(); }
+
+    /**
+    * @brief Gets the weight of an arc in a travel mode.
+    * @param a The arc index.
+    * @param driving True for the driving time, false for the walking time.
+    * @return The weight.
+    */
+    double getWeight(uint32_t a, bool driving) const {
+        const SegmentWeights &s = segments_[arcs_[a].segment];
+        return driving ? s.driving : s.walking;
+    }
+
+    /**
+    * @brief Gets the driving profile of an arc.
+    * @param a The arc index.
+    * @return The profile index, NO_PROFILE if its driving time is constant.
+    */
+    uint16_t getProfile(uint32_t a) const { return profiles_.empty() ? NO_PROFILE : profiles_[arcs_[a].segment]; }
+};
+
+#endif //ROUTINGGRAPH_H
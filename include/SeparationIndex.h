@@ -0,0 +1,72 @@
+#ifndef SEPARATIONINDEX_H
+#define SEPARATIONINDEX_H
+
+#include <cstdint>
+#include <vector>
+
+#include "RoutingGraph.h"
+
+/**
+ * @class SeparationIndex
+ * @brief Articulation points and bridges of the routing graph, from one depth-first search.
+ *
+ * Answers whether removing a single node, or every segment between two nodes, separates two nodes
+ * of the same component. A node x splits its component into the subtrees of its children c with
+ * low(c) >= disc(x), plus the rest; a tree segment (p, c) is a bridge when low(c) > disc(p) and then
+ * separates the subtree of c from the rest.
+ */
+class SeparationIndex {
+private:
+    std::vector<uint32_t> disc_; /**< Discovery time of each node in the depth-first search. */
+    std::vector<uint32_t> finish_; /**< One past the largest discovery time in the subtree of each node. */
+    std::vector<uint32_t> low_; /**< Smallest discovery time reachable from the subtree with one back arc. */
+    std::vector<uint32_t> parent_; /**< Parent in the depth-first forest, NO_NODE for roots. */
+    std::vector<uint32_t> first_child_; /**< Children of node u are children_[first_child_[u]] to children_[first_child_[u+1]-1]. */
+    std::vector<uint32_t> children_; /**< Children of each node, by increasing discovery time. */
+
+    /**
+    * @brief Checks if a node is in the subtree of another.
+    * @param root The root of the subtree.
+    * @param u The node.
+    * @return True if u is root or one of its descendants.
+    */
+    bool inSubtree(uint32_t root, uint32_t u) const { return disc_[root] <= disc_[u] && disc_[u] < finish_[root]; }
+
+    /**
+    * @brief Finds the piece of a node when another node is removed.
+    * @param x The removed node.
+    * @param u A node other than x, in the same component.
+    * @return The child of x heading the separated subtree u is in, or NO_NODE if u stays with the rest.
+    */
+    uint32_t pieceWithout(uint32_t x, uint32_t u) const;
+
+public:
+    /**
+    * @brief Builds the index.
+    * @details **Time Complexity** O(V+E)
+    * @param graph The routing graph, whose segments are undirected.
+    * @param isDriving If true, segments that cannot be driven are ignored.
+    */
+    void build(const RoutingGraph &graph, bool isDriving);
+
+    /**
+    * @brief Checks if removing a node disconnects two other nodes.
+    * @param x The removed node.
+    * @param s A node in the same component as t.
+    * @param t A node in the same component as s.
+    * @return True if every route between s and t goes through x (false if x is s or t).
+    */
+    bool nodeSeparates(uint32_t x, uint32_t s, uint32_t t) const;
+
+    /**
+    * @brief Checks if removing every segment between two adjacent nodes disconnects two nodes.
+    * @param u One endpoint of the removed segments.
+    * @param v The other endpoint.
+    * @param s A node in the same component as t.
+    * @param t A node in the same component as s.
+    * @return True if the segments form a bridge with s and t on different sides.
+    */
+    bool segmentSeparates(uint32_t u, uint32_t v, uint32_t s, uint32_t t) const;
+};
+
+#endif //SEPARATIONINDEX_H
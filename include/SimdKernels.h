@@ -0,0 +1,102 @@
+#ifndef SIMDKERNELS_H
+#define SIMDKERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "RoutingGraph.h"
+
+#define SIMD_SCALAR 0 /**< @brief Plain scalar loops, available everywhere */
+#define SIMD_SSE4 1 /**< @brief 128-bit SSE4.1 kernels */
+#define SIMD_AVX2 2 /**< @brief 256-bit AVX2 kernels, with gathers */
+
+#define SIMD_RELAX_BLOCK 64 /**< @brief Largest number of arcs relaxed by one relaxArcs call, one bit of its mask each */
+
+/**
+ * @class SimdKernels
+ * @brief Vectorized inner loops of the queries, with scalar versions giving the same results.
+ *
+ * The instruction set is chosen at run time among the ones the processor supports. The SSE4 and AVX2 versions are
+ * compiled for their own target whatever the flags of the build, so one binary runs on any x86-64 processor;
+ * other architectures only have the scalar ones. The scalar kernels stay the default: the labels of a hierarchy
+ * share long runs of hubs, which a branchy scalar merge predicts well, so the vector merges only pay off on some
+ * processors, and the benchmark compares every level on the machine at hand.
+ */
+class SimdKernels {
+private:
+    static int level_; /**< Instruction set used by the kernels, one of the SIMD_* levels, SIMD_SCALAR by default. */
+
+public:
+    /**
+    * @brief Finds the best instruction set the processor supports.
+    * @return One of the SIMD_* levels.
+    */
+    static int detectLevel();
+
+    /**
+    * @brief Selects the instruction set of the kernels.
+    * @param level One of the SIMD_* levels.
+    * @return True if the processor supports it, false otherwise (the level is then left unchanged).
+    */
+    static bool setLevel(int level);
+
+    /**
+    * @brief Gets the instruction set of the kernels.
+    * @return One of the SIMD_* levels.
+    */
+    static int getLevel() { return level_; }
+
+    /**
+    * @brief Parses an instruction set name as given on the command line.
+    * @param name One of "auto", "scalar", "sse4" or "avx2".
+    * @param level Set to the matching SIMD_* level, the best one the processor supports for "auto".
+    * @return True if the name is valid.
+    */
+    static bool parseLevel(const std::string &name, int &level);
+
+    /**
+    * @brief Gets the command line name of an instruction set.
+    * @param level One of the SIMD_* levels.
+    * @return The name.
+    */
+    static const char *getLevelName(int level);
+
+    /**
+    * @brief Finds the smallest distance sum over the hubs two labels have in common.
+    *
+    * The vector versions compare a block of each label against every hub of the block of the other label,
+    * then advance the block with the smaller last hub, without a branch on the hubs themselves.
+    *
+    * @details **Time Complexity** O(A+B)
+    * @param hubs_a Hubs of the first label, strictly increasing.
+    * @param dists_a Distance to each hub of the first label.
+    * @param size_a Number of entries of the first label.
+    * @param hubs_b Hubs of the second label, strictly increasing.
+    * @param dists_b Distance to each hub of the second label.
+    * @param size_b Number of entries of the second label.
+    * @return The smallest sum, infinity if the labels have no hub in common.
+    */
+    static double intersectLabels(const uint32_t *hubs_a, const double *dists_a, size_t size_a,
+                                  const uint32_t *hubs_b, const double *dists_b, size_t size_b);
+
+    /**
+    * @brief Finds which arcs of a contiguous block would improve the distance of their target.
+    *
+    * Only compares; the caller relaxes the arcs of the mask in order, checking each one again, since an arc
+    * may lead to a node already improved by an earlier arc of the block.
+    *
+    * @details **Time Complexity** O(count)
+    * @param arcs The first arc of the block, in the routing graph's arc array.
+    * @param count Number of arcs, at most SIMD_RELAX_BLOCK.
+    * @param segments The routing graph's segment weights.
+    * @param isDriving True for driving times, false for walking times.
+    * @param dist Distance of each node.
+    * @param base Distance of the node the arcs leave.
+    * @return Bit i is set if base plus the weight of arc i is below the distance of its target.
+    */
+    static uint64_t relaxArcs(const RoutingArc *arcs, uint32_t count, const SegmentWeights *segments, bool isDriving,
+                              const double *dist, double base);
+};
+
+#endif //SIMDKERNELS_H
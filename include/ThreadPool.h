@@ -0,0 +1,141 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @struct TaskQueue
+ * @brief Tasks queued by one thread of a pool, taken from the back by that thread and stolen from the front by the others.
+ */
+typedef struct {
+    std::mutex mutex; /**< Guards the tasks. */
+    std::deque<std::function<void()>> tasks; /**< Queued tasks, newest at the back. */
+} TaskQueue;
+
+/**
+ * @class ThreadPool
+ * @brief Work-stealing pool of threads shared by everything that runs in parallel, so no subsystem starts threads of its own.
+ *
+ * Each thread of the pool queues the tasks it creates on its own queue and runs the newest one first; an idle thread
+ * steals the oldest task of another queue. Threads outside the pool share queue 0 and, while waiting on a TaskGroup,
+ * run queued tasks instead of blocking, so tasks may start and wait on tasks of their own. Worker i of a pool of
+ * size n is numbered 1..n-1; every other thread counts as worker 0, which lets callers keep per-worker scratch arrays.
+ * A pool of size 1 has no threads and runs every task inline.
+ */
+class ThreadPool {
+private:
+    std::vector<std::unique_ptr<TaskQueue>> queues_; /**< Queue of each worker, queue 0 for the threads outside the pool. */
+    std::vector<std::thread> threads_; /**< Threads of workers 1..n-1. */
+    std::mutex sleep_mutex_; /**< Guards sleeping on wake_. */
+    std::condition_variable wake_; /**< Wakes idle workers when a task is queued or the pool stops. */
+    std::atomic<int> queued_{0}; /**< Number of queued tasks, in every queue. */
+    bool stopping_ = false; /**< Whether the workers must exit, set under sleep_mutex_. */
+
+    static thread_local const ThreadPool *current_pool_; /**< Pool the calling thread belongs to, nullptr outside any pool. */
+    static thread_local int current_worker_; /**< Worker index of the calling thread in current_pool_. */
+    static int shared_threads_; /**< Size of the shared pool, read when it is first used. */
+
+    /**
+    * @brief Runs tasks until the pool stops, sleeping while there are none.
+    * @param worker The worker index.
+    */
+    void work(int worker);
+
+public:
+    /**
+    * @brief Constructs a pool and starts its threads.
+    * @param threads Number of workers, counting the threads outside the pool as worker 0 (at least 1).
+    */
+    explicit ThreadPool(int threads);
+
+    /**
+    * @brief Stops the threads once they finish their current task; tasks still queued are dropped.
+    */
+    ~ThreadPool();
+
+    /**
+    * @brief Gets the number of workers.
+    * @return The number of workers, including worker 0.
+    */
+    int size() const { return queues_.size(); }
+
+    /**
+    * @brief Gets the worker index of the calling thread.
+    * @return 1..size()-1 on a thread of this pool, 0 on any other thread.
+    */
+    int workerIndex() const { return current_pool_ == this ? current_worker_ : 0; }
+
+    /**
+    * @brief Queues a task on the queue of the calling thread.
+    * @param task The task, which must not throw.
+    */
+    void submit(std::function<void()> task);
+
+    /**
+    * @brief Runs one queued task on the calling thread, preferring its own queue.
+    * @return True if a task was run, false if every queue was empty.
+    */
+    bool runPending();
+
+    /**
+    * @brief Runs body(i) for every i in [begin, end) on the pool and waits for all of them.
+    * @param begin The first index.
+    * @param end The index after the last one.
+    * @param body The function to run, called concurrently for different indices.
+    */
+    void parallelFor(size_t begin, size_t end, const std::function<void(size_t)> &body);
+
+    /**
+    * @brief Sets the size of the shared pool, before it is first used.
+    * @param threads Number of workers, including worker 0.
+    */
+    static void setSharedThreads(int threads);
+
+    /**
+    * @brief Gets the pool shared by the program, started on first use with the size set by setSharedThreads (1 by default).
+    * @return The shared pool.
+    */
+    static ThreadPool &shared();
+};
+
+/**
+ * @class TaskGroup
+ * @brief Set of tasks run on a pool that can be waited for together.
+ */
+class TaskGroup {
+private:
+    ThreadPool &pool_; /**< Pool the tasks run on. */
+    std::atomic<int> pending_{0}; /**< Tasks started and not yet finished. */
+
+public:
+    /**
+    * @brief Constructs an empty group.
+    * @param pool The pool to run the tasks on.
+    */
+    explicit TaskGroup(ThreadPool &pool) : pool_(pool) {}
+
+    /**
+    * @brief Waits for the tasks still running.
+    */
+    ~TaskGroup() { wait(); }
+
+    /**
+    * @brief Starts a task, or runs it at once on a pool of size 1.
+    * @param task The task, which must not throw.
+    */
+    void run(std::function<void()> task);
+
+    /**
+    * @brief Waits until every task of the group finished, running queued tasks in the meantime.
+    */
+    void wait();
+};
+
+#endif //THREADPOOL_H
@@ -0,0 +1,88 @@
+#ifndef TRAVELTIMEPROFILES_H
+#define TRAVELTIMEPROFILES_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#define NO_PROFILE UINT16_MAX /**< @brief Profile index meaning "constant travel time" */
+#define MINUTES_PER_DAY 1440 /**< @brief Period of the profiles, in minutes */
+
+/**
+ * @struct ProfilePoint
+ * @brief Breakpoint of a time-of-day profile.
+ */
+typedef struct {
+    float minute; /**< Time of day, in minutes after midnight. */
+    float factor; /**< Factor applied to the base driving time of a segment entered at that time. */
+} ProfilePoint;
+
+/**
+ * @class TravelTimeProfiles
+ * @brief Shared table of time-of-day driving profiles, referenced by index from the segments.
+ *
+ * A profile is a piecewise-linear factor over the day, repeating every 24 hours: between two breakpoints the
+ * factor is interpolated linearly, and after the last breakpoint it heads back to the first one of the next day.
+ * A segment entered at time t takes its base driving time times the factor at t. Many segments share a few
+ * profiles, so each segment only stores a 16-bit index.
+ */
+class TravelTimeProfiles {
+private:
+    std::vector<uint32_t> first_ = {0}; /**< Breakpoints of profile p are points_[first_[p]] to points_[first_[p+1]-1]. */
+    std::vector<ProfilePoint> points_; /**< Breakpoints of every profile, by increasing minute within a profile. */
+    std::unordered_map<int, uint16_t> index_; /**< Profile index of each profile ID of the profile file. */
+
+public:
+    /**
+    * @brief Removes every profile.
+    */
+    void clear();
+
+    /**
+    * @brief Parses a profile file, replacing the current profiles.
+    *
+    * The file has a header line and the columns Profile,Time,Factor, with the time as HH:MM and a positive
+    * factor. Rows of a profile may come in any order; rows with an invalid time or factor are skipped.
+    *
+    * @param profile_file The path to the profile file.
+    * @return True if the file was read, false otherwise.
+    */
+    bool parse(const std::string& profile_file);
+
+    /**
+    * @brief Finds the profile with an ID of the profile file.
+    * @param id The profile ID.
+    * @return The profile index, NO_PROFILE if there is no such profile.
+    */
+    uint16_t find(int id) const;
+
+    /**
+    * @brief Gets the factor of a profile at a time.
+    * @details **Time Complexity** O(log P) for the P breakpoints of the profile
+    * @param profile The profile index.
+    * @param minute The time, in minutes after midnight of the first day (not negative).
+    * @return The interpolated factor.
+    */
+    double getFactor(uint16_t profile, double minute) const;
+
+    /**
+    * @brief Checks if a segment with a profile keeps its travel times first-in first-out.
+    *
+    * Entering later must never mean leaving earlier, which holds when the factor never falls
+    * faster than 1/base per minute. Time-dependent searches are only exact on such segments.
+    *
+    * @param profile The profile index.
+    * @param base The base driving time of the segment.
+    * @return True if no later departure arrives earlier.
+    */
+    bool isFifo(uint16_t profile, double base) const;
+
+    /**
+    * @brief Gets the number of profiles.
+    * @return The number of profiles.
+    */
+    uint32_t size() const { return first_.size() - 1; }
+};
+
+#endif //TRAVELTIMEPROFILES_H
@@ -1,12 +1,145 @@
 #include <iostream>
 #include <stack>
+#include <string>
 
 #include "Menu.h"
+#include "NodeOrdering.h"
+#include "OutputSink.h"
+#include "QueryLog.h"
+#include "QueryServer.h"
+#include "QueryStats.h"
+#include "SimdKernels.h"
+#include "ThreadPool.h"
+
+/**
+ * @brief Loads the network once and answers requests over a local socket until killed.
+ * Usage: --serve <locations.csv> <distances.csv> [--port N | --socket PATH] [--workers N] [--format text|jsonl|binary] [--stats] [--record FILE] [--order input|bfs|rcm|nd] [--cch] [--profiles FILE] [--search-threads N] [--delta W] [--pool-threads N] [--hub-labels] [--label-file FILE] [--simd auto|scalar|sse4|avx2]
+ */
+int serve(int argc, char *argv[]) {
+    if (argc < 4) {
+        std::cerr << "Usage: " << argv[0] << " --serve <locations.csv> <distances.csv> [--port N | --socket PATH] [--workers N] [--format text|jsonl|binary] [--stats] [--record FILE] [--order input|bfs|rcm|nd] [--cch] [--profiles FILE] [--search-threads N] [--delta W] [--pool-threads N] [--hub-labels] [--label-file FILE] [--simd auto|scalar|sse4|avx2]" << std::endl;
+        return 1;
+    }
+
+    int port = DEFAULT_SERVER_PORT;
+    int workers = DEFAULT_SERVER_WORKERS;
+    int format = FORMAT_TEXT;
+    int order = ORDER_INPUT;
+    bool hierarchy = false;
+    bool hub_labels = false;
+    int simd = SIMD_SCALAR;
+    int search_threads = 1;
+    double delta = 0;
+    std::string socket_path, profile_file, label_file;
+
+    for (int i = 4; i < argc; i++) {
+        std::string option = argv[i];
+        if (option == "--stats") QueryStats::setEnabled(true);
+        else if (option == "--cch") hierarchy = true;
+        else if (option == "--hub-labels") hub_labels = true;
+        else if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << option << std::endl;
+            return 1;
+        }
+        else if (option == "--port") port = std::stoi(argv[++i]);
+        else if (option == "--socket") socket_path = argv[++i];
+        else if (option == "--profiles") profile_file = argv[++i];
+        else if (option == "--workers") workers = std::stoi(argv[++i]);
+        else if (option == "--search-threads") search_threads = std::stoi(argv[++i]);
+        else if (option == "--delta") delta = std::stod(argv[++i]);
+        else if (option == "--pool-threads") ThreadPool::setSharedThreads(std::stoi(argv[++i]));
+        else if (option == "--label-file") {
+            hub_labels = true;
+            label_file = argv[++i];
+        }
+        else if (option == "--format" && OutputSink::parseFormat(argv[i + 1], format)) i++;
+        else if (option == "--order" && NodeOrdering::parseOrder(argv[i + 1], order)) i++;
+        else if (option == "--simd" && SimdKernels::parseLevel(argv[i + 1], simd) && SimdKernels::setLevel(simd)) i++;
+        else if (option == "--record") {
+            if (!QueryLog::open(argv[++i])) {
+                std::cerr << "Could not open query log " << argv[i] << std::endl;
+                return 1;
+            }
+        }
+        else {
+            std::cerr << "Unknown option " << option << std::endl;
+            return 1;
+        }
+    }
+
+    RouteNetwork network;
+    network.setNodeOrder(order);
+    network.setHierarchy(hierarchy);
+    network.setProfileFile(profile_file);
+    network.setSearchThreads(search_threads, delta);
+    network.setHubLabels(hub_labels, label_file);
+    if (!network.parseData(argv[2], argv[3])) return 1;
+
+    QueryServer server(network, workers, format);
+    bool listening = socket_path.empty() ? server.listenTcp(port) : server.listenUnix(socket_path);
+    if (!listening) {
+        std::cerr << "Could not listen on " << (socket_path.empty() ? "port " + std::to_string(port) : socket_path) << std::endl;
+        return 1;
+    }
+
+    std::cout << "Serving " << network.getNumberOfLocations() << " locations on "
+              << (socket_path.empty() ? "127.0.0.1:" + std::to_string(port) : socket_path) << std::endl;
+    server.run();
+    return 0;
+}
 
 // TIP To <b>Run</b> code, press <shortcut actionId="Run"/> or
 // click the <icon src="AllIcons.Actions.Execute"/> icon in the gutter.
-int main() {
+int main(int argc, char *argv[]) {
+    if (argc > 1 && std::string(argv[1]) == "--serve") {
+        return serve(argc, argv);
+    }
+
+    // [--output session|append|per-request|stdout|none] [--format text|jsonl|binary] [--stats] [--record FILE] [--order input|bfs|rcm|nd] [--cch] [--profiles FILE] [--search-threads N] [--delta W] [--pool-threads N] [--hub-labels] [--label-file FILE] [--simd auto|scalar|sse4|avx2]
+    int output_mode = SINK_SESSION;
+    int format = FORMAT_TEXT;
+    int order = ORDER_INPUT;
+    bool hierarchy = false;
+    bool hub_labels = false;
+    int simd = SIMD_SCALAR;
+    int search_threads = 1;
+    double delta = 0;
+    std::string profile_file, label_file;
+    for (int i = 1; i < argc; i++) {
+        std::string option = argv[i];
+        bool valid = true;
+        if (option == "--stats") QueryStats::setEnabled(true);
+        else if (option == "--cch") hierarchy = true;
+        else if (option == "--hub-labels") hub_labels = true;
+        else if (i + 1 < argc && option == "--output") valid = OutputSink::parseMode(argv[++i], output_mode);
+        else if (i + 1 < argc && option == "--format") valid = OutputSink::parseFormat(argv[++i], format);
+        else if (i + 1 < argc && option == "--record") valid = QueryLog::open(argv[++i]);
+        else if (i + 1 < argc && option == "--order") valid = NodeOrdering::parseOrder(argv[++i], order);
+        else if (i + 1 < argc && option == "--simd") valid = SimdKernels::parseLevel(argv[++i], simd) && SimdKernels::setLevel(simd);
+        else if (i + 1 < argc && option == "--profiles") profile_file = argv[++i];
+        else if (i + 1 < argc && option == "--search-threads") search_threads = std::stoi(argv[++i]);
+        else if (i + 1 < argc && option == "--delta") delta = std::stod(argv[++i]);
+        else if (i + 1 < argc && option == "--pool-threads") ThreadPool::setSharedThreads(std::stoi(argv[++i]));
+        else if (i + 1 < argc && option == "--label-file") {
+            hub_labels = true;
+            label_file = argv[++i];
+        }
+        else valid = false;
+        if (!valid) {
+            std::cerr << "Usage: " << argv[0] << " [--output session|append|per-request|stdout|none] [--format text|jsonl|binary] [--stats] [--record FILE] [--order input|bfs|rcm|nd] [--cch] [--profiles FILE] [--search-threads N] [--delta W] [--pool-threads N] [--hub-labels] [--label-file FILE] [--simd auto|scalar|sse4|avx2]" << std::endl;
+            return 1;
+        }
+    }
+    OutputSink sink(output_mode);
+    sink.setFormat(format);
+    RequestProcessor::setOutputSink(&sink);
+
     RouteNetwork *network = new RouteNetwork();
+    network->setNodeOrder(order);
+    network->setHierarchy(hierarchy);
+    network->setProfileFile(profile_file);
+    network->setSearchThreads(search_threads, delta);
+    network->setHubLabels(hub_labels, label_file);
     std::stack<Menu*> menu;
 
 
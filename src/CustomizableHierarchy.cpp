@@ -0,0 +1,178 @@
+#include "CustomizableHierarchy.h"
+
+#include <algorithm>
+#include <climits>
+#include <limits>
+
+#include "NodeOrdering.h"
+#include "ThreadPool.h"
+
+static const double UNREACHED = std::numeric_limits<double>::infinity();
+
+void CustomizableHierarchy::build(const RoutingGraph &graph) {
+    num_nodes_ = graph.getNumNodes();
+    node_ = NodeOrdering::compute(graph, ORDER_ND);
+    rank_.assign(num_nodes_, 0);
+    for (uint32_t r = 0; r < num_nodes_; r++) rank_[node_[r]] = r;
+
+    std::vector<std::vector<uint32_t>> up(num_nodes_);
+    for (uint32_t u = 0; u < num_nodes_; u++) {
+        for (uint32_t a = graph.firstArc(u); a < graph.endArc(u); a++) {
+            uint32_t v = graph.getArc(a).target;
+            if (rank_[u] < rank_[v]) up[rank_[u]].push_back(rank_[v]);
+        }
+    }
+
+    // contracting r connects its upward neighbours; it is enough to hand them to the lowest one,
+    // which is contracted next among them and passes them on in turn
+    first_up_.assign(num_nodes_ + 1, 0);
+    parent_.assign(num_nodes_, NO_NODE);
+    head_.clear();
+    tail_.clear();
+    for (uint32_t r = 0; r < num_nodes_; r++) {
+        std::vector<uint32_t> &neighbours = up[r];
+        std::sort(neighbours.begin(), neighbours.end());
+        neighbours.erase(std::unique(neighbours.begin(), neighbours.end()), neighbours.end());
+        first_up_[r] = head_.size();
+        head_.insert(head_.end(), neighbours.begin(), neighbours.end());
+        tail_.insert(tail_.end(), neighbours.size(), r);
+        if (!neighbours.empty()) {
+            parent_[r] = neighbours[0];
+            up[parent_[r]].insert(up[parent_[r]].end(), neighbours.begin() + 1, neighbours.end());
+        }
+        std::vector<uint32_t>().swap(neighbours);
+    }
+    first_up_[num_nodes_] = head_.size();
+
+    arc_edge_.assign(graph.getNumArcs(), NO_NODE);
+    for (uint32_t u = 0; u < num_nodes_; u++) {
+        for (uint32_t a = graph.firstArc(u); a < graph.endArc(u); a++) {
+            uint32_t v = graph.getArc(a).target;
+            if (rank_[u] < rank_[v]) arc_edge_[a] = findEdge(rank_[u], rank_[v]);
+        }
+    }
+}
+
+uint32_t CustomizableHierarchy::findEdge(uint32_t lower, uint32_t upper) const {
+    auto begin = head_.begin() + first_up_[lower];
+    auto end = head_.begin() + first_up_[lower + 1];
+    return std::lower_bound(begin, end, upper) - head_.begin();
+}
+
+void CustomizableHierarchy::customize(const RoutingGraph &graph) {
+    // the metrics share no arrays, so they are customized at the same time
+    TaskGroup group(ThreadPool::shared());
+    group.run([this, &graph] { customizeMetric(graph, true); });
+    customizeMetric(graph, false);
+    group.wait();
+}
+
+void CustomizableHierarchy::customizeMetric(const RoutingGraph &graph, bool isDriving) {
+    std::vector<double> &weight = weight_[isDriving];
+    std::vector<uint32_t> &via = via_[isDriving];
+    weight.assign(head_.size(), UNREACHED);
+    via.assign(head_.size(), NO_NODE);
+
+    for (uint32_t a = 0; a < graph.getNumArcs(); a++) {
+        uint32_t e = arc_edge_[a];
+        double w = graph.getWeight(a, isDriving);
+        if (e != NO_NODE && w < INT_MAX && w < weight[e]) weight[e] = w; // segments that cannot be driven stay unreached
+    }
+
+    // every lower triangle of an edge has its middle below both endpoints, so by the time an edge is
+    // read as the lower side of a triangle all its own triangles have been seen
+    for (uint32_t r = 0; r < num_nodes_; r++) {
+        for (uint32_t i = first_up_[r]; i < first_up_[r + 1]; i++) {
+            if (weight[i] == UNREACHED) continue;
+            uint32_t x = head_[i];
+            uint32_t e = first_up_[x];
+            for (uint32_t j = i + 1; j < first_up_[r + 1]; j++) {
+                while (head_[e] != head_[j]) e++; // the other upward neighbours of r are upward neighbours of x
+                double w = weight[i] + weight[j];
+                if (w < weight[e]) {
+                    weight[e] = w;
+                    via[e] = r;
+                }
+            }
+        }
+    }
+}
+
+bool CustomizableHierarchy::query(uint32_t s, uint32_t t, bool isDriving, HierarchySearchState &state, std::vector<uint32_t> &nodes, std::vector<double> &weights) const {
+    nodes.clear();
+    weights.clear();
+    if (s == t) return false;
+
+    if (state.dist[0].size() != num_nodes_) {
+        for (int side = 0; side < 2; side++) {
+            state.dist[side].assign(num_nodes_, UNREACHED);
+            state.pred[side].assign(num_nodes_, NO_NODE);
+        }
+    }
+    const std::vector<double> &weight = weight_[isDriving];
+    uint32_t start[2] = {rank_[s], rank_[t]};
+    for (int side = 0; side < 2; side++) {
+        std::vector<double> &dist = state.dist[side];
+        dist[start[side]] = 0;
+        for (uint32_t x = start[side]; x != NO_NODE; x = parent_[x]) {
+            if (dist[x] == UNREACHED) continue;
+            for (uint32_t e = first_up_[x]; e < first_up_[x + 1]; e++) {
+                double d = dist[x] + weight[e];
+                if (d < dist[head_[e]]) {
+                    dist[head_[e]] = d;
+                    state.pred[side][head_[e]] = e;
+                }
+            }
+        }
+    }
+
+    // the upward searches only meet on common ancestors of s and t
+    double best = UNREACHED;
+    uint32_t meet = NO_NODE;
+    for (uint32_t x = start[0]; x != NO_NODE; x = parent_[x]) {
+        if (state.dist[0][x] + state.dist[1][x] < best) {
+            best = state.dist[0][x] + state.dist[1][x];
+            meet = x;
+        }
+    }
+
+    if (meet != NO_NODE) {
+        std::vector<uint32_t> up_edges;
+        for (uint32_t x = meet; x != start[0]; x = tail_[state.pred[0][x]]) up_edges.push_back(state.pred[0][x]);
+        for (auto it = up_edges.rbegin(); it != up_edges.rend(); ++it) unpack(*it, true, isDriving, nodes, weights);
+        for (uint32_t x = meet; x != start[1]; x = tail_[state.pred[1][x]]) unpack(state.pred[1][x], false, isDriving, nodes, weights);
+    }
+
+    for (int side = 0; side < 2; side++) {
+        for (uint32_t x = start[side]; x != NO_NODE; x = parent_[x]) {
+            state.dist[side][x] = UNREACHED;
+            state.pred[side][x] = NO_NODE;
+        }
+    }
+    return meet != NO_NODE;
+}
+
+void CustomizableHierarchy::unpack(uint32_t edge, bool upwards, bool isDriving, std::vector<uint32_t> &nodes, std::vector<double> &weights) const {
+    std::vector<std::pair<uint32_t, bool>> stack = {{edge, upwards}};
+    while (!stack.empty()) {
+        auto [e, up] = stack.back();
+        stack.pop_back();
+        uint32_t middle = via_[isDriving][e];
+        if (middle == NO_NODE) {
+            nodes.push_back(node_[up ? head_[e] : tail_[e]]);
+            weights.push_back(weight_[isDriving][e]);
+            continue;
+        }
+        // the shortcut tail -> middle -> head, pushed so that the half at the start of the walk is unpacked first
+        uint32_t to_tail = findEdge(middle, tail_[e]);
+        uint32_t to_head = findEdge(middle, head_[e]);
+        if (up) {
+            stack.emplace_back(to_head, true);
+            stack.emplace_back(to_tail, false);
+        }
+        else {
+            stack.emplace_back(to_tail, true);
+            stack.emplace_back(to_head, false);
+        }
+    }
+}
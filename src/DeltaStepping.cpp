@@ -0,0 +1,227 @@
+#include "DeltaStepping.h"
+
+#include <algorithm>
+#include <climits>
+#include <thread>
+
+#include "RouteNetwork.h"
+#include "SpinBarrier.h"
+
+#define IN_FRONTIER 1
+#define SETTLED 2
+
+DeltaStepping::~DeltaStepping() {
+    stopTeam();
+}
+
+void DeltaStepping::configure(int threads, double delta) {
+    if (std::max(threads, 1) != threads_) stopTeam();
+    threads_ = std::max(threads, 1);
+    delta_ = std::max(delta, 0.0);
+}
+
+void DeltaStepping::stopTeam() {
+    {
+        std::lock_guard<std::mutex> lock(team_mutex_);
+        stopping_ = true;
+    }
+    start_.notify_all();
+    for (auto &thread : team_) thread.join();
+    team_.clear();
+    stopping_ = false;
+}
+
+void DeltaStepping::serve(uint32_t t, uint64_t seen) {
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(team_mutex_);
+            start_.wait(lock, [this, seen] { return stopping_ || job_ != seen; });
+            if (stopping_) return;
+            seen = job_;
+        }
+        work(*job_graph_, *job_context_, *job_state_, job_delta_, t, *job_barrier_);
+        {
+            std::lock_guard<std::mutex> lock(team_mutex_);
+            if (++done_ < threads_ - 1) continue;
+        }
+        finished_.notify_one();
+    }
+}
+
+void DeltaStepping::resetDelta() {
+    mean_weight_[0] = mean_weight_[1] = -1;
+    max_weight_[0] = max_weight_[1] = -1;
+}
+
+double DeltaStepping::getDelta(const RoutingGraph &graph, bool isDriving) {
+    if (max_weight_[isDriving] < 0) {
+        double sum = 0, max = 0;
+        uint32_t count = 0;
+        for (uint32_t a = 0; a < graph.getNumArcs(); a++) {
+            double w = graph.getWeight(a, isDriving);
+            if (w >= INT_MAX) continue;
+            sum += w;
+            max = std::max(max, w);
+            count++;
+        }
+        mean_weight_[isDriving] = count ? sum / count : 0;
+        max_weight_[isDriving] = max;
+    }
+
+    double delta = delta_ > 0 ? delta_ : mean_weight_[isDriving];
+    if (!(delta > 0)) delta = 1; // every weight is 0
+    return std::max(delta, max_weight_[isDriving] / DELTA_MAX_BUCKETS);
+}
+
+void DeltaStepping::receive(SearchState &state, double delta, uint32_t t) {
+    QueryCounters &stats = counters_[t];
+    for (int s = 0; s < threads_; s++) {
+        std::vector<Relaxation> &inbox = outbox_[s * threads_ + t];
+        for (const Relaxation &r : inbox) {
+            if (state.dist[r.node] <= r.dist) continue;
+            state.dist[r.node] = r.dist;
+            state.parent[r.node] = r.parent;
+            state.parentArc[r.node] = r.arc;
+            buckets_[t][size_t(r.dist / delta) % num_buckets_].push_back(r.node);
+            stats.decreaseKeys++;
+            stats.heapInserts++;
+        }
+        inbox.clear();
+    }
+}
+
+void DeltaStepping::work(const RoutingGraph &graph, const SearchContext &context, SearchState &state, double delta, uint32_t t, SpinBarrier &barrier) {
+    QueryCounters &stats = counters_[t];
+    std::vector<std::vector<uint32_t>> &buckets = buckets_[t];
+    std::vector<uint32_t> frontier, settled;
+    bool mode = state.isDriving;
+    int parity = 0;
+    size_t current = 0;
+
+    // sends the relaxations of the arcs of u that are light (or heavy) to the owners of their targets
+    auto expand = [&](uint32_t u, bool heavy) {
+        for (uint32_t a = graph.firstArc(u); a < graph.endArc(u); a++) {
+            double w = graph.getWeight(a, mode);
+            if (w >= INT_MAX || (w > delta) != heavy) continue;
+            if (context.blockedSegments[graph.getArc(a).segment]) {
+                stats.blockedHits++;
+                continue;
+            }
+            stats.edgesRelaxed++;
+            uint32_t v = graph.getArc(a).target;
+            outbox_[t * threads_ + owner(v)].push_back({v, u, a, state.dist[u] + w});
+        }
+    };
+
+    while (true) {
+        // every worker agrees on the lowest non-empty bucket of all
+        size_t next = SIZE_MAX;
+        for (size_t i = 0; i < num_buckets_; i++) {
+            if (!buckets[(current + i) % num_buckets_].empty()) {
+                next = current + i;
+                break;
+            }
+        }
+        next_bucket_[parity][t] = next;
+        barrier.wait();
+        next = *std::min_element(next_bucket_[parity].begin(), next_bucket_[parity].end());
+        parity ^= 1;
+        if (next == SIZE_MAX) break;
+        current = next;
+
+        // light arcs, until no worker refills the bucket
+        while (true) {
+            frontier.swap(buckets[current % num_buckets_]);
+            for (uint32_t u : frontier) {
+                stats.extractMins++;
+                if ((marks_[u] & IN_FRONTIER) || size_t(state.dist[u] / delta) != current) continue; // stale entry
+                marks_[u] |= IN_FRONTIER;
+                if (context.blockedNodes[u]) {
+                    stats.blockedHits++;
+                    continue;
+                }
+                if (!(marks_[u] & SETTLED)) {
+                    marks_[u] |= SETTLED;
+                    settled.push_back(u);
+                    stats.verticesSettled++;
+                }
+                expand(u, false);
+            }
+            for (uint32_t u : frontier) marks_[u] &= ~IN_FRONTIER;
+            frontier.clear();
+
+            barrier.wait();
+            receive(state, delta, t);
+            active_[parity][t] = !buckets[current % num_buckets_].empty();
+            barrier.wait();
+            bool refilled = std::find(active_[parity].begin(), active_[parity].end(), 1) != active_[parity].end();
+            parity ^= 1;
+            if (!refilled) break;
+        }
+
+        // heavy arcs, once per node with its final distance
+        for (uint32_t u : settled) {
+            marks_[u] = 0;
+            expand(u, true);
+        }
+        settled.clear();
+        barrier.wait();
+        receive(state, delta, t);
+    }
+}
+
+void DeltaStepping::run(RouteNetwork &rn, SearchState &state) {
+    std::lock_guard<std::mutex> run_lock(run_mutex_);
+    const RoutingGraph &graph = rn.getRoutingGraph();
+    double delta = getDelta(graph, state.isDriving);
+    num_buckets_ = size_t(max_weight_[state.isDriving] / delta) + 2;
+
+    buckets_.resize(threads_);
+    for (auto &buckets : buckets_) {
+        buckets.resize(num_buckets_);
+        for (auto &bucket : buckets) bucket.clear();
+    }
+    outbox_.resize(threads_ * threads_);
+    for (auto &outbox : outbox_) outbox.clear();
+    marks_.assign(graph.getNumNodes(), 0);
+    for (int p = 0; p < 2; p++) {
+        next_bucket_[p].assign(threads_, SIZE_MAX);
+        active_[p].assign(threads_, 0);
+    }
+    counters_.assign(threads_, QueryCounters());
+
+    buckets_[owner(state.source)][0].push_back(state.source);
+    counters_[owner(state.source)].heapInserts++;
+
+    const SearchContext &context = rn.getSearchContext();
+    SpinBarrier barrier(threads_);
+    for (int t = team_.size() + 1; t < threads_; t++) team_.emplace_back(&DeltaStepping::serve, this, t, job_);
+    {
+        std::lock_guard<std::mutex> lock(team_mutex_);
+        job_graph_ = &graph;
+        job_context_ = &context;
+        job_state_ = &state;
+        job_delta_ = delta;
+        job_barrier_ = &barrier;
+        done_ = 0;
+        job_++;
+    }
+    start_.notify_all();
+    work(graph, context, state, delta, 0, barrier);
+    {
+        // the team still reads the shared buffers after the last barrier
+        std::unique_lock<std::mutex> lock(team_mutex_);
+        finished_.wait(lock, [this] { return done_ == threads_ - 1; });
+    }
+
+    QueryCounters *stats = QueryStats::current();
+    if (!stats) return;
+    for (const QueryCounters &c : counters_) {
+        stats->heapInserts += c.heapInserts;
+        stats->decreaseKeys += c.decreaseKeys;
+        stats->extractMins += c.extractMins;
+        stats->edgesRelaxed += c.edgesRelaxed;
+        stats->verticesSettled += c.verticesSettled;
+        stats->blockedHits += c.blockedHits;
+    }
+}
@@ -0,0 +1,189 @@
+#include "HubLabels.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <fstream>
+#include <limits>
+
+#include "SimdKernels.h"
+
+static const double UNREACHED = std::numeric_limits<double>::infinity();
+
+/**
+ * @brief Writes the contents of a vector to a binary stream, after its size.
+ */
+template <typename T>
+static void writeArray(std::ofstream &out, const std::vector<T> &values) {
+    uint64_t size = values.size();
+    out.write(reinterpret_cast<const char*>(&size), sizeof(size));
+    out.write(reinterpret_cast<const char*>(values.data()), size * sizeof(T));
+}
+
+/**
+ * @brief Reads a vector written by writeArray, refusing more than a given number of values.
+ */
+template <typename T>
+static bool readArray(std::ifstream &in, std::vector<T> &values, uint64_t max_size) {
+    uint64_t size = 0;
+    if (!in.read(reinterpret_cast<char*>(&size), sizeof(size)) || size > max_size) return false;
+    values.resize(size);
+    return bool(in.read(reinterpret_cast<char*>(values.data()), size * sizeof(T)));
+}
+
+void HubLabels::clear() {
+    rank_.clear();
+    for (int m = 0; m < 2; m++) {
+        first_[m].clear();
+        hubs_[m].clear();
+        dists_[m].clear();
+    }
+    fingerprint_ = 0;
+}
+
+void HubLabels::build(const RoutingGraph &graph, const CustomizableHierarchy &cch) {
+    clear();
+    uint32_t n = cch.getNumNodes();
+    rank_.resize(n);
+    for (uint32_t v = 0; v < n; v++) rank_[v] = cch.getRank(v);
+    buildMetric(cch, false);
+    buildMetric(cch, true);
+    fingerprint_ = fingerprint(graph);
+}
+
+void HubLabels::buildMetric(const CustomizableHierarchy &cch, bool isDriving) {
+    uint32_t n = cch.getNumNodes();
+    std::vector<uint32_t> &hubs = hubs_[isDriving];
+    std::vector<double> &dists = dists_[isDriving];
+    std::vector<uint32_t> begin(n), end(n);
+    std::vector<double> best(n, UNREACHED);
+    std::vector<uint32_t> touched;
+
+    // labels are built from the highest rank down, so the labels of the upward neighbours are ready
+    for (uint32_t r = n; r-- > 0;) {
+        touched.assign(1, r);
+        best[r] = 0;
+        for (uint32_t e = cch.firstUp(r); e < cch.endUp(r); e++) {
+            double w = cch.getUpWeight(e, isDriving);
+            if (w == UNREACHED) continue;
+            uint32_t u = cch.getHead(e);
+            for (uint32_t k = begin[u]; k < end[u]; k++) {
+                uint32_t h = hubs[k];
+                if (best[h] == UNREACHED) touched.push_back(h);
+                best[h] = std::min(best[h], w + dists[k]);
+            }
+        }
+        std::sort(touched.begin(), touched.end());
+
+        // a hub reached faster through another hub of the label is never where a shortest path peaks;
+        // the margin keeps hubs whose detour is only shorter by rounding
+        begin[r] = hubs.size();
+        for (uint32_t h : touched) {
+            bool dominated = false;
+            for (uint32_t k = begin[h]; k < end[h] && h != r && !dominated; k++) {
+                dominated = best[hubs[k]] + dists[k] < best[h] * (1 - 1e-12);
+            }
+            if (dominated) continue;
+            hubs.push_back(h);
+            dists.push_back(best[h]);
+        }
+        end[r] = hubs.size();
+        for (uint32_t h : touched) best[h] = UNREACHED;
+    }
+
+    // lay the labels out by increasing rank
+    std::vector<uint32_t> sorted_hubs;
+    std::vector<double> sorted_dists;
+    sorted_hubs.reserve(hubs.size());
+    sorted_dists.reserve(dists.size());
+    std::vector<uint32_t> &first = first_[isDriving];
+    first.assign(n + 1, 0);
+    for (uint32_t r = 0; r < n; r++) {
+        first[r] = sorted_hubs.size();
+        sorted_hubs.insert(sorted_hubs.end(), hubs.begin() + begin[r], hubs.begin() + end[r]);
+        sorted_dists.insert(sorted_dists.end(), dists.begin() + begin[r], dists.begin() + end[r]);
+    }
+    first[n] = sorted_hubs.size();
+    hubs.swap(sorted_hubs);
+    dists.swap(sorted_dists);
+}
+
+double HubLabels::query(uint32_t s, uint32_t t, bool isDriving) const {
+    if (s == t) return 0;
+    const std::vector<uint32_t> &first = first_[isDriving];
+    const uint32_t *hubs = hubs_[isDriving].data();
+    const double *dists = dists_[isDriving].data();
+
+    uint32_t i = first[rank_[s]], j = first[rank_[t]];
+    double best = SimdKernels::intersectLabels(hubs + i, dists + i, first[rank_[s] + 1] - i,
+                                               hubs + j, dists + j, first[rank_[t] + 1] - j);
+    return best == UNREACHED ? INT_MAX : best;
+}
+
+uint64_t HubLabels::fingerprint(const RoutingGraph &graph) {
+    // FNV-1a over the node count, every arc and the weights it is searched with
+    uint64_t hash = 14695981039346656037ULL;
+    auto add = [&hash](uint64_t value) {
+        for (int i = 0; i < 8; i++) {
+            hash ^= (value >> (8 * i)) & 0xff;
+            hash *= 1099511628211ULL;
+        }
+    };
+    add(graph.getNumNodes());
+    for (uint32_t a = 0; a < graph.getNumArcs(); a++) {
+        add(graph.getArc(a).target);
+        for (bool isDriving : {false, true}) {
+            double w = graph.getWeight(a, isDriving);
+            uint64_t bits;
+            std::memcpy(&bits, &w, sizeof(bits));
+            add(bits);
+        }
+    }
+    for (uint32_t u = 0; u < graph.getNumNodes(); u++) add(graph.endArc(u));
+    return hash;
+}
+
+bool HubLabels::save(const std::string &label_file) const {
+    std::ofstream out(label_file, std::ios::binary | std::ios::trunc);
+    if (!out) return false;
+
+    uint32_t header[2] = {HUB_LABEL_MAGIC, HUB_LABEL_VERSION};
+    out.write(reinterpret_cast<const char*>(header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(&fingerprint_), sizeof(fingerprint_));
+    writeArray(out, rank_);
+    for (int m = 0; m < 2; m++) {
+        writeArray(out, first_[m]);
+        writeArray(out, hubs_[m]);
+        writeArray(out, dists_[m]);
+    }
+    return bool(out);
+}
+
+bool HubLabels::load(const std::string &label_file, const RoutingGraph &graph) {
+    std::ifstream in(label_file, std::ios::binary);
+    uint32_t header[2] = {0, 0};
+    uint64_t stored = 0;
+    if (!in.read(reinterpret_cast<char*>(header), sizeof(header)) || header[0] != HUB_LABEL_MAGIC || header[1] != HUB_LABEL_VERSION) return false;
+    if (!in.read(reinterpret_cast<char*>(&stored), sizeof(stored)) || stored != fingerprint(graph)) return false;
+
+    clear();
+    uint32_t n = graph.getNumNodes();
+    bool valid = readArray(in, rank_, n) && rank_.size() == n;
+    for (int m = 0; m < 2 && valid; m++) {
+        valid = readArray(in, first_[m], uint64_t(n) + 1) && first_[m].size() == uint64_t(n) + 1
+             && readArray(in, hubs_[m], first_[m][n]) && hubs_[m].size() == first_[m][n]
+             && readArray(in, dists_[m], first_[m][n]) && dists_[m].size() == first_[m][n];
+    }
+    // a damaged file must not lead queries out of the arrays
+    for (uint32_t v = 0; v < n && valid; v++) valid = rank_[v] < n;
+    for (int m = 0; m < 2 && valid; m++) {
+        for (uint32_t r = 0; r < n && valid; r++) valid = first_[m][r] <= first_[m][r + 1];
+        for (size_t k = 0; k < hubs_[m].size() && valid; k++) valid = hubs_[m][k] < n;
+    }
+    if (!valid) {
+        clear();
+        return false;
+    }
+    fingerprint_ = stored;
+    return true;
+}
@@ -1,8 +1,12 @@
 #include "InputHandler.h"
 
+#include <algorithm>
 #include <fstream>
+#include <iomanip>
 #include <limits>
 
+#include "QueryStats.h"
+
 
 void InputHandler::waitForInput() {
     std::cout << std::endl << "Press enter to continue ..." << std::endl;
@@ -35,6 +39,22 @@ void InputHandler::trimString(std::string &str) {
 
 
 
+bool InputHandler::parseClockTime(const std::string& input, int &minutes) {
+    int hours, mins;
+    char sep, rest;
+    std::istringstream ss(input);
+    if (!(ss >> hours >> sep >> mins) || sep != ':' || ss >> rest) return false;
+    if (hours < 0 || hours > 23 || mins < 0 || mins > 59) return false;
+    minutes = hours * 60 + mins;
+    return true;
+}
+
+std::string InputHandler::formatClockTime(int minutes) {
+    std::ostringstream time;
+    time << std::setw(2) << std::setfill('0') << minutes / 60 << ":" << std::setw(2) << std::setfill('0') << minutes % 60;
+    return time.str();
+}
+
 std::string InputHandler::toLowerString(const std::string& input) {
     std::string lowerStr = input;
     std::transform(lowerStr.begin(), lowerStr.end(), lowerStr.begin(),
@@ -60,12 +80,14 @@ void InputHandler::parseDriving(Request &route, std::string key, std::string val
             if (key != "Source") {correct = false; break;}
             try {route.src = std::stoi(value);}
             catch (const std::invalid_argument&) {correct = false;}
+            catch (const std::out_of_range&) {correct = false;}
             break;
         }
         case 2: {
             if (key != "Destination") {correct = false; break;}
             try {route.dest = std::stoi(value);}
             catch (const std::invalid_argument&) {correct = false;}
+            catch (const std::out_of_range&) {correct = false;}
             break;
         }
         case 3: {
@@ -98,6 +120,7 @@ void InputHandler::parseDriving(Request &route, std::string key, std::string val
              if(!value.empty()) {
                  try {route.includeNode = std::stoi(value);}
                  catch (const std::invalid_argument&) {correct = false;}
+                 catch (const std::out_of_range&) {correct = false;}
              }
             break;
         }
@@ -119,18 +142,21 @@ void InputHandler::parseDrivingWalking(Request &route, std::string key, std::str
             if (key != "Source") {correct = false; break;}
             try {route.src = std::stoi(value);}
             catch (const std::invalid_argument&) {correct = false;}
+            catch (const std::out_of_range&) {correct = false;}
             break;
         }
         case 2: {
             if (key != "Destination") {correct = false; break;}
             try {route.dest = std::stoi(value);}
             catch (const std::invalid_argument&) {correct = false;}
+            catch (const std::out_of_range&) {correct = false;}
             break;
         }
         case 3: {
             if (key != "MaxWalkTime") {correct = false; break;}
             try {route.maxWalkTime = std::stoi(value);}
             catch (const std::invalid_argument&) {correct = false;}
+            catch (const std::out_of_range&) {correct = false;}
             break;
         }
         case 4: {
@@ -167,27 +193,188 @@ void InputHandler::parseDrivingWalking(Request &route, std::string key, std::str
 }
 
 
+void InputHandler::parseReachability(Request &route, std::string key, std::string value, int idx, bool &correct) {
+    switch (idx) {
+        case 0: {
+            if (key != "Mode") { correct = false; break;}
+            route.mode = value;
+            break;
+        }
+        case 1: {
+            if (key != "Source") {correct = false; break;}
+            try {route.src = std::stoi(value);}
+            catch (const std::invalid_argument&) {correct = false;}
+            catch (const std::out_of_range&) {correct = false;}
+            break;
+        }
+        case 2: {
+            if (key != "TravelMode" || (value != "driving" && value != "walking" && value != "driving-walking")) {correct = false; break;}
+            route.travelMode = value;
+            break;
+        }
+        case 3: {
+            if (key != "MaxTime") {correct = false; break;}
+            try {route.maxTime = std::stoi(value);}
+            catch (const std::invalid_argument&) {correct = false;}
+            catch (const std::out_of_range&) {correct = false;}
+            break;
+        }
+        case 4: {
+            if (key != "ParkingOnly" || (value != "0" && value != "1")) {correct = false; break;}
+            route.parkingOnly = value == "1";
+            break;
+        }
+        default: break;
+    }
+}
+
+
+void InputHandler::parseNearestParking(Request &route, std::string key, std::string value, int idx, bool &correct) {
+    switch (idx) {
+        case 0: {
+            if (key != "Mode") { correct = false; break;}
+            route.mode = value;
+            break;
+        }
+        case 1: {
+            if (key != "Source") {correct = false; break;}
+            try {route.src = std::stoi(value);}
+            catch (const std::invalid_argument&) {correct = false;}
+            catch (const std::out_of_range&) {correct = false;}
+            break;
+        }
+        case 2: {
+            if (key != "TravelMode" || (value != "driving" && value != "walking")) {correct = false; break;}
+            route.travelMode = value;
+            break;
+        }
+        case 3: {
+            if (key != "Count") {correct = false; break;}
+            try {route.count = std::stoi(value);}
+            catch (const std::invalid_argument&) {correct = false;}
+            catch (const std::out_of_range&) {correct = false;}
+            if (route.count <= 0) correct = false;
+            break;
+        }
+        default: break;
+    }
+}
+
+
+void InputHandler::parseDistance(Request &route, std::string key, std::string value, int idx, bool &correct) {
+    switch (idx) {
+        case 0: {
+            if (key != "Mode") { correct = false; break;}
+            route.mode = value;
+            break;
+        }
+        case 1: {
+            if (key != "Source") {correct = false; break;}
+            try {route.src = std::stoi(value);}
+            catch (const std::invalid_argument&) {correct = false;}
+            catch (const std::out_of_range&) {correct = false;}
+            break;
+        }
+        case 2: {
+            if (key != "Destination") {correct = false; break;}
+            try {route.dest = std::stoi(value);}
+            catch (const std::invalid_argument&) {correct = false;}
+            catch (const std::out_of_range&) {correct = false;}
+            break;
+        }
+        case 3: {
+            if (key != "TravelMode" || (value != "driving" && value != "walking")) {correct = false; break;}
+            route.travelMode = value;
+            break;
+        }
+        default: break;
+    }
+}
+
+
 Request InputHandler::parseInputFile(const std::string& filepath, bool &correct) {
-    Request route;
     std::ifstream file(filepath);
-    std::string line;
 
     if (!file) {
         std::cerr << "Error: Could not open file " << filepath << "\n";
         correct = false;
-        return route;
+        return Request();
     }
 
+    Request route = parseRequest(file, correct);
+
+    file.close();
+    return route;
+}
+
+Request InputHandler::parseRequestLine(const std::string& line, bool &correct) {
+    std::string block = line;
+    std::replace(block.begin(), block.end(), ';', '\n');
+    std::istringstream in(block);
+    return parseRequest(in, correct);
+}
+
+std::string InputHandler::formatRequestLine(const Request& request) {
+    std::ostringstream line;
+    if (request.mode == "reachability") {
+        line << "Mode:reachability;Source:" << request.src << ";TravelMode:" << request.travelMode
+        << ";MaxTime:" << request.maxTime << ";ParkingOnly:" << request.parkingOnly;
+        return line.str();
+    }
+    if (request.mode == "nearest-parking") {
+        line << "Mode:nearest-parking;Source:" << request.src << ";TravelMode:" << request.travelMode << ";Count:" << request.count;
+        return line.str();
+    }
+    if (request.mode == "distance") {
+        line << "Mode:distance;Source:" << request.src << ";Destination:" << request.dest << ";TravelMode:" << request.travelMode;
+        return line.str();
+    }
+    line << "Mode:" << request.mode << ";Source:" << request.src << ";Destination:" << request.dest;
+    bool walks = request.mode == "driving-walking" || request.mode == "driving-walking-pareto";
+    if (walks) line << ";MaxWalkTime:" << request.maxWalkTime;
+
+    line << ";AvoidNodes:";
+    for (size_t i = 0; i < request.avoidNodes.size(); i++) {
+        if (i > 0) line << ",";
+        line << request.avoidNodes[i];
+    }
+    line << ";AvoidSegments:";
+    for (size_t i = 0; i < request.avoidSegments.size(); i++) {
+        if (i > 0) line << ",";
+        line << "(" << request.avoidSegments[i].first << "," << request.avoidSegments[i].second << ")";
+    }
+
+    if (!walks) {
+        line << ";IncludeNode:";
+        if (request.includeNode >= 0) line << request.includeNode;
+    }
+    if (request.departureTime >= 0) line << ";DepartureTime:" << formatClockTime(request.departureTime);
+    return line.str();
+}
+
+Request InputHandler::parseRequest(std::istream& in, bool &correct) {
+    PhaseTimer timer(PHASE_PARSE);
+    Request route;
+    std::string line;
     int idx = 0;
 
-    while(getline(file, line)) {
+    while(getline(in, line)) {
         std::istringstream iss(line);
         std::string key, value;
         getline(iss >> std::ws, key, ':'); // Remove leading whitespace
         getline(iss >> std::ws, value);    // Remove leading whitespace in value
         value = value.substr(0, value.find("\r"));
 
-        if (value == "driving" || route.mode == "driving") {
+        if (key == "DepartureTime" && (route.mode == "driving" || route.mode == "driving-walking" || route.mode == "driving-walking-pareto")) {
+            // optional, so it is not one of the numbered keys
+            if (!parseClockTime(value, route.departureTime)) correct = false;
+            continue;
+        }
+
+        if (value == "reachability" || route.mode == "reachability") parseReachability(route, key, value, idx, correct);
+        else if (value == "nearest-parking" || route.mode == "nearest-parking") parseNearestParking(route, key, value, idx, correct);
+        else if (value == "distance" || route.mode == "distance") parseDistance(route, key, value, idx, correct);
+        else if (value == "driving" || route.mode == "driving") {
             parseDriving(route, key, value, idx, correct);
         }
         else parseDrivingWalking(route, key, value, idx, correct);
@@ -196,9 +383,11 @@ Request InputHandler::parseInputFile(const std::string& filepath, bool &correct)
     }
 
     if (route.mode == "driving" && (idx >= 4 && idx <= 5)) correct = false;
-    if (route.mode == "driving-walking" && idx != 6) correct = false;
+    if ((route.mode == "driving-walking" || route.mode == "driving-walking-pareto") && idx != 6) correct = false;
+    if (route.mode == "reachability" && (idx < 4 || idx > 5)) correct = false;
+    if (route.mode == "nearest-parking" && idx != 4) correct = false;
+    if (route.mode == "distance" && idx != 4) correct = false;
 
-    file.close();
     return route;
 }
 
@@ -219,6 +408,10 @@ Request InputHandler::parseInputFile(const std::string& filepath, bool &correct)
             std::cerr << "Invalid number detected: '" << token << "'. Skipping.\n";
             avoidLocations.clear();
             return avoidLocations;
+        } catch (const std::out_of_range&) {
+            std::cerr << "Number out of range: '" << token << "'. Skipping.\n";
+            avoidLocations.clear();
+            return avoidLocations;
         }
     }
 
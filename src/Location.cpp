@@ -35,6 +35,14 @@ void Location::setCanPark(bool canPark) {
     canPark_ = canPark;
 }
 
+uint32_t Location::getIndex() const {
+    return index_;
+}
+
+void Location::setIndex(uint32_t index) {
+    index_ = index;
+}
+
 void Location::printInfo() {
     std::cout << "Location ID: "<< id_ << std::endl;
     std::cout << "Location Name: "<< name_ << std::endl;
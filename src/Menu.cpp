@@ -1,6 +1,7 @@
 #include "Menu.h"
 #include <filesystem>
 
+#include "QueryStats.h"
 #include "RequestProcessor.h"
 
 Menu::Menu(RouteNetwork &route_network) : route_network_(route_network) {}
@@ -78,6 +79,7 @@ void MainMenu::show() {
     std::cout << "(" << ++options << ") >> " << "Go to Locations  Menu" << std::endl;
     std::cout << "(" << ++options << ") >> " << "Go to Routes Menu" << std::endl;
     std::cout << "(" << ++options << ") >> " << "Process Input" << std::endl;
+    if (QueryStats::isEnabled()) std::cout << "(" << ++options << ") >> " << "Show query statistics" << std::endl;
     std::cout << "(0) >> Go back "  << "Exit" << std::endl;
 }
 
@@ -100,6 +102,10 @@ Menu *MainMenu::getNextMenu() {
         case 3: {
             return new InputMenu(route_network_);
         }
+        case 4: {
+            if (QueryStats::isEnabled()) QueryStats::dump(std::cout);
+            break;
+        }
     }
     InputHandler::waitForInput();
 
@@ -179,6 +185,7 @@ void InputMenu::show() {
         for (const auto &file : files) {
             std::cout << "(" << ++options << ") >> " << file.string() << std::endl;
         }
+        std::cout << "(" << ++options << ") >> " << "Process all files in batch" << std::endl;
     } catch (const std::filesystem::filesystem_error &e) {
         std::cout << e.code() << " " << e.what() << std::endl;
     }
@@ -207,8 +214,27 @@ Menu *InputMenu::getNextMenu() {
 
     if (option == 0) return nullptr;
 
+    if (option == int(files.size()) + 1) {
+        std::vector<Request> requests;
+        for (const auto &file : files) {
+            bool correctFile = true;
+            Request r = InputHandler::parseInputFile(directory + file.string(), correctFile);
+            if (correctFile) requests.push_back(r);
+            else std::cout << "Input file " << file.string() << " not within predefined standards" << std::endl;
+        }
+        RequestProcessor::processBatch(requests, route_network_, ID_MODE);
+
+        InputHandler::waitForInput();
+        return this;
+    }
+
+    if (option < 0 || option > int(files.size())) {
+        return invalidInput();
+    }
+
     std::string filepath = directory + files[option - 1].string();
     bool correctFile = true;
+    QueryScope scope;
     Request r = InputHandler::parseInputFile(filepath, correctFile);
 
     if (correctFile) {
@@ -0,0 +1,159 @@
+#include "NodeOrdering.h"
+
+#include <algorithm>
+#include <numeric>
+
+std::vector<uint32_t> NodeOrdering::compute(const RoutingGraph &graph, int order) {
+    switch (order) {
+        case ORDER_BFS:
+            return breadthFirst(graph, false);
+        case ORDER_RCM: {
+            std::vector<uint32_t> nodes = breadthFirst(graph, true);
+            std::reverse(nodes.begin(), nodes.end());
+            return nodes;
+        }
+        case ORDER_ND:
+            return nestedDissection(graph);
+        default: {
+            std::vector<uint32_t> nodes(graph.getNumNodes());
+            std::iota(nodes.begin(), nodes.end(), 0);
+            return nodes;
+        }
+    }
+}
+
+std::vector<uint32_t> NodeOrdering::breadthFirst(const RoutingGraph &graph, bool byDegree) {
+    uint32_t n = graph.getNumNodes();
+    auto degree = [&graph](uint32_t u) { return graph.endArc(u) - graph.firstArc(u); };
+    auto lowerDegree = [&degree](uint32_t a, uint32_t b) { return degree(a) < degree(b); };
+
+    std::vector<uint32_t> starts(n);
+    std::iota(starts.begin(), starts.end(), 0);
+    if (byDegree) std::stable_sort(starts.begin(), starts.end(), lowerDegree);
+
+    std::vector<char> visited(n, 0);
+    std::vector<uint32_t> nodes;
+    nodes.reserve(n);
+
+    for (uint32_t s : starts) {
+        if (visited[s]) continue;
+        visited[s] = 1;
+        nodes.push_back(s);
+        // nodes doubles as the queue: the unprocessed part starts at head
+        for (size_t head = nodes.size() - 1; head < nodes.size(); head++) {
+            uint32_t u = nodes[head];
+            size_t first = nodes.size();
+            for (uint32_t a = graph.firstArc(u); a < graph.endArc(u); a++) {
+                uint32_t v = graph.getArc(a).target;
+                if (visited[v]) continue;
+                visited[v] = 1;
+                nodes.push_back(v);
+            }
+            if (byDegree) std::stable_sort(nodes.begin() + first, nodes.end(), lowerDegree);
+        }
+    }
+    return nodes;
+}
+
+void NodeOrdering::pieceLevels(const RoutingGraph &graph, uint32_t start, const std::vector<uint32_t> &piece,
+                               std::vector<uint32_t> &level, std::vector<uint32_t> &nodes) {
+    nodes.clear();
+    nodes.push_back(start);
+    level[start] = 0;
+    for (size_t head = 0; head < nodes.size(); head++) {
+        uint32_t u = nodes[head];
+        for (uint32_t a = graph.firstArc(u); a < graph.endArc(u); a++) {
+            uint32_t v = graph.getArc(a).target;
+            if (piece[v] != piece[start] || level[v] != NO_NODE) continue;
+            level[v] = level[u] + 1;
+            nodes.push_back(v);
+        }
+    }
+}
+
+std::vector<uint32_t> NodeOrdering::nestedDissection(const RoutingGraph &graph) {
+    uint32_t n = graph.getNumNodes();
+    std::vector<uint32_t> order(n);
+    std::vector<uint32_t> piece(n, 0); // NO_NODE once a node has its position
+    std::vector<uint32_t> level(n, NO_NODE);
+    uint32_t pieces = 1;
+
+    // pieces still to order, with the first position of each
+    std::vector<std::pair<std::vector<uint32_t>, uint32_t>> stack;
+    stack.emplace_back(compute(graph, ORDER_INPUT), 0);
+    std::vector<uint32_t> visited;
+
+    while (!stack.empty()) {
+        std::vector<uint32_t> nodes = std::move(stack.back().first);
+        uint32_t first = stack.back().second;
+        stack.pop_back();
+        if (nodes.empty()) continue;
+
+        pieceLevels(graph, nodes[0], piece, level, visited);
+        if (visited.size() < nodes.size()) {
+            std::vector<uint32_t> rest;
+            for (uint32_t v : visited) piece[v] = pieces;
+            for (uint32_t v : nodes) {
+                if (piece[v] != pieces) rest.push_back(v);
+            }
+            pieces++;
+            for (uint32_t v : visited) level[v] = NO_NODE;
+            stack.emplace_back(std::move(rest), first + visited.size());
+            stack.emplace_back(visited, first);
+            continue;
+        }
+
+        // restart from the last node reached, which is far from every other one
+        uint32_t far = visited.back();
+        for (uint32_t v : visited) level[v] = NO_NODE;
+        pieceLevels(graph, far, piece, level, visited);
+
+        std::vector<uint32_t> count(level[visited.back()] + 1, 0);
+        for (uint32_t v : visited) count[level[v]]++;
+        uint32_t size = visited.size(), before = 0, separator = NO_NODE, median = 0;
+        for (uint32_t l = 0; l < count.size(); l++) {
+            uint32_t after = size - before - count[l];
+            if (4 * before >= size && 4 * after >= size && (separator == NO_NODE || count[l] < count[separator])) separator = l;
+            if (2 * (before + count[l]) <= size) median = l + 1;
+            before += count[l];
+        }
+        if (separator == NO_NODE) separator = std::min<uint32_t>(median, count.size() - 1);
+
+        std::vector<uint32_t> lower, upper;
+        uint32_t last = first + size;
+        for (uint32_t v : visited) {
+            if (level[v] < separator) lower.push_back(v);
+            else if (level[v] > separator) upper.push_back(v);
+            else {
+                order[--last] = v;
+                piece[v] = NO_NODE;
+            }
+            level[v] = NO_NODE;
+        }
+        for (uint32_t v : lower) piece[v] = pieces;
+        for (uint32_t v : upper) piece[v] = pieces + 1;
+        pieces += 2;
+        uint32_t lower_size = lower.size();
+        stack.emplace_back(std::move(upper), first + lower_size);
+        stack.emplace_back(std::move(lower), first);
+    }
+    return order;
+}
+
+bool NodeOrdering::parseOrder(const std::string &name, int &order) {
+    if (name == "input") order = ORDER_INPUT;
+    else if (name == "bfs") order = ORDER_BFS;
+    else if (name == "rcm") order = ORDER_RCM;
+    else if (name == "nd") order = ORDER_ND;
+    else return false;
+    return true;
+}
+
+const char *NodeOrdering::getOrderName(int order) {
+    switch (order) {
+        case ORDER_BFS: return "bfs";
+        case ORDER_RCM: return "rcm";
+        case ORDER_ND: return "nd";
+        default: return "input";
+    }
+}
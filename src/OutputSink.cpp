@@ -0,0 +1,88 @@
+#include "OutputSink.h"
+
+#include <utility>
+
+OutputSink::OutputSink(int mode, std::string path, bool echo) : mode_(mode), path_(std::move(path)), echo_(echo) {}
+
+OutputSink::~OutputSink() {
+    if (!buffer_.str().empty()) endRequest();
+    if (file_.is_open()) file_.close();
+}
+
+bool OutputSink::openFile() {
+    if (mode_ == SINK_STDOUT || mode_ == SINK_NONE || failed_) return false;
+    if (file_.is_open()) return true;
+
+    if (mode_ == SINK_PER_REQUEST) {
+        // output.txt -> output_1.txt, output_2.txt, ...
+        std::string path = path_;
+        size_t dot = path.find_last_of('.');
+        size_t slash = path.find_last_of('/');
+        std::string suffix = "_" + std::to_string(requests_ + 1);
+        if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) path += suffix;
+        else path.insert(dot, suffix);
+        file_.open(path, std::ios::out | std::ios::binary);
+    }
+    else if (mode_ == SINK_APPEND) file_.open(path_, std::ios::out | std::ios::binary | std::ios::app);
+    else file_.open(path_, std::ios::out | std::ios::binary);
+
+    if (!file_) {
+        std::cerr << "Error opening file " << path_ << "!" << std::endl;
+        failed_ = true;
+        return false;
+    }
+    return true;
+}
+
+void OutputSink::endRequest() {
+    std::string text = buffer_.str();
+
+    if (mode_ != SINK_NONE && (mode_ == SINK_STDOUT || (echo_ && format_ != FORMAT_BINARY))) {
+        std::cout.write(text.data(), text.size());
+    }
+    if (openFile()) {
+        file_.write(text.data(), text.size());
+        if (mode_ == SINK_PER_REQUEST) file_.close();
+    }
+
+    buffer_.str("");
+    requests_++;
+}
+
+void OutputSink::write(const char *data, size_t size) {
+    buffer_.write(data, size);
+}
+
+std::string OutputSink::str() const {
+    return buffer_.str();
+}
+
+int OutputSink::getMode() const {
+    return mode_;
+}
+
+bool OutputSink::parseMode(const std::string &name, int &mode) {
+    if (name == "session") mode = SINK_SESSION;
+    else if (name == "append") mode = SINK_APPEND;
+    else if (name == "per-request") mode = SINK_PER_REQUEST;
+    else if (name == "stdout") mode = SINK_STDOUT;
+    else if (name == "none") mode = SINK_NONE;
+    else return false;
+    return true;
+}
+
+int OutputSink::getFormat() const {
+    return format_;
+}
+
+void OutputSink::setFormat(int format) {
+    format_ = format;
+}
+
+bool OutputSink::parseFormat(const std::string &name, int &format) {
+    if (name == "text") format = FORMAT_TEXT;
+    else if (name == "jsonl") format = FORMAT_JSONL;
+    else if (name == "binary") format = FORMAT_BINARY;
+    else return false;
+    return true;
+}
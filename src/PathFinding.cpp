@@ -1,122 +1,395 @@
 #include "PathFinding.h"
 
-bool PathFinding::relax(Edge<std::string>* route, bool isDriving) {
-    auto u = route->getOrig();
-    auto v = route->getDest();
-    if (isDriving) {
-        if (v->getDist() > u->getDist() + route->getDrivingTime()) {
-            v->setDist(u->getDist() + route->getDrivingTime());
-            v->setPath(route);
-            return true;
-        }
+#include <algorithm>
+
+#include "QueryStats.h"
+#include "SimdKernels.h"
+#include "ThreadPool.h"
+
+bool PathFinding::relax(SearchState &state, const RoutingGraph &graph, uint32_t u, uint32_t arc, bool isDriving) {
+    uint32_t v = graph.getArc(arc).target;
+    double d = state.dist[u] + graph.getWeight(arc, isDriving);
+    if (state.dist[v] > d) {
+        state.dist[v] = d;
+        state.parent[v] = u;
+        state.parentArc[v] = arc;
+        return true;
     }
-    else {
-        if (v->getDist() > u->getDist() + route->getWalkingTime()) {
-            v->setDist(u->getDist() + route->getWalkingTime());
-            v->setPath(route);
-            return true;
-        }
+    return false;
+}
+
+bool PathFinding::relaxAt(SearchState &state, const RoutingGraph &graph, const TravelTimeProfiles &profiles, uint32_t u, uint32_t arc) {
+    uint32_t v = graph.getArc(arc).target;
+    double w = graph.getWeight(arc, state.isDriving);
+    uint16_t profile = graph.getProfile(arc);
+    if (state.isDriving && profile != NO_PROFILE && w < INT_MAX) w *= profiles.getFactor(profile, state.departure + state.dist[u]);
+    double d = state.dist[u] + w;
+    if (state.dist[v] > d) {
+        state.dist[v] = d;
+        state.parent[v] = u;
+        state.parentArc[v] = arc;
+        return true;
     }
     return false;
+}
 
+double PathFinding::searchDeparture(RouteNetwork *rn, bool mode) {
+    return mode == DRIVING_MODE && rn->isTimeDependent() ? rn->getDepartureTime() : -1;
 }
 
 void PathFinding::dijkstra(RouteNetwork* rn, int src_id, bool mode) {
-    for (auto& p : rn->getLocationSet() ){
-        p->setDist(INT_MAX);
-        p->setPath(nullptr);
-    }
+    PhaseTimer timer(PHASE_SEARCH);
+    QueryCounters *stats = QueryStats::current();
+    if (stats) stats->searches++;
+
+    const RoutingGraph &graph = rn->getRoutingGraph();
+    SearchContext &context = rn->getSearchContext();
+    SearchState &state = context.search;
+    uint32_t n = graph.getNumNodes();
+    state.dist.assign(n, INT_MAX);
+    state.parent.assign(n, NO_NODE);
+    state.parentArc.assign(n, NO_NODE);
+    if (state.heapPos.size() != n) state.heapPos.assign(n, 0);
 
     Location* org = rn->getLocationById(src_id);
-    org->setDist(0);
-    MutablePriorityQueue<Vertex<std::string>> pq;
+    state.dist[org->getIndex()] = 0;
+    state.source = org->getIndex();
+    state.isDriving = mode;
+    state.departure = searchDeparture(rn, mode);
+    state.blockedNodes = context.blockedNodeList.size();
+    state.blockedSegments = context.blockedSegmentList.size();
+    // the delta-stepping team runs one search at a time, so searches on pool workers, which run side by side, keep to Dijkstra
+    if (rn->getSearchThreads() > 1 && state.departure < 0 && ThreadPool::shared().workerIndex() == 0) {
+        rn->getDeltaStepping().run(*rn, state);
+        return;
+    }
+
+    const TravelTimeProfiles &profiles = rn->getProfiles();
+    bool timed = state.departure >= 0;
+    // without profiles or blocked segments, the vector kernels compare every arc of a node at once and only the improving ones are relaxed
+    bool vectorized = !timed && context.blockedSegmentList.empty() && SimdKernels::getLevel() != SIMD_SCALAR;
+    IndexedPriorityQueue pq(state.dist);
 
-    for (auto v: rn->getLocationSet()) {
+    for (uint32_t v = 0; v < n; v++) {
         pq.insert(v);
+        if (stats) stats->heapInserts++;
     }
 
     while (!pq.empty()) {
-        auto u = pq.extractMin();
-        if (rn->isNodeBlocked(u)) continue;
+        uint32_t u = pq.extractMin();
+        if (stats) stats->extractMins++;
+        if (context.blockedNodes[u]) {
+            if (stats) stats->blockedHits++;
+            continue;
+        }
+        if (stats) stats->verticesSettled++;
 
-        for (auto e : u->getAdj()) {
-            if (rn->isEdgeBlocked(e)) continue;
+        if (vectorized) {
+            for (uint32_t block = graph.firstArc(u); block < graph.endArc(u); block += SIMD_RELAX_BLOCK) {
+                uint32_t count = std::min<uint32_t>(graph.endArc(u) - block, SIMD_RELAX_BLOCK);
+                uint64_t improved = SimdKernels::relaxArcs(graph.getArcData() + block, count, graph.getSegmentData(), mode,
+                                                           state.dist.data(), state.dist[u]);
+                if (stats) stats->edgesRelaxed += count;
+                for (; improved != 0; improved &= improved - 1) {
+                    uint32_t a = block + __builtin_ctzll(improved);
+                    if (relax(state, graph, u, a, mode)) {
+                        pq.decreaseKey(graph.getArc(a).target);
+                        if (stats) stats->decreaseKeys++;
+                    }
+                }
+            }
+            continue;
+        }
 
-            if (relax(e, mode)) {
-                auto* v = e->getDest();
-                pq.decreaseKey(v);
+        for (uint32_t a = graph.firstArc(u); a < graph.endArc(u); a++) {
+            if (context.blockedSegments[graph.getArc(a).segment]) {
+                if (stats) stats->blockedHits++;
+                continue;
+            }
 
+            if (stats) stats->edgesRelaxed++;
+            if (timed ? relaxAt(state, graph, profiles, u, a) : relax(state, graph, u, a, mode)) {
+                pq.decreaseKey(graph.getArc(a).target);
+                if (stats) stats->decreaseKeys++;
             }
         }
     }
  }
 
-std::vector<Location*> PathFinding::getVectorPath(RouteNetwork *rn, const int &origin, const int &dest, double &weight, bool isDriving) {
-    Location *v = rn->getLocationById(dest);
-    Location *org = rn->getLocationById(origin);
-    std::vector<Location*> path;
-    std::stack<Location*> s;
-    s.push(v);
-    if (v->getPath() == nullptr) return path;
+void PathFinding::repairTree(RouteNetwork *rn) {
+    const RoutingGraph &graph = rn->getRoutingGraph();
+    SearchContext &context = rn->getSearchContext();
+    SearchState &state = context.search;
+    Span<uint32_t> blockedNodes = context.blockedNodeList;
+    Span<uint32_t> blockedArcs = context.blockedSegmentList;
+    if (state.blockedNodes == blockedNodes.size() && state.blockedSegments == blockedArcs.size()) return;
 
-    while (v != nullptr && v != org) {
-        if (isDriving) weight += v->getPath()->getDrivingTime();
-        else weight += v->getPath()->getWalkingTime();
+    PhaseTimer timer(PHASE_SEARCH);
+    QueryCounters *stats = QueryStats::current();
+    if (stats) stats->searches++;
 
-        v = static_cast<Location*>(v->getPath()->getOrig());
-        s.push(v);
+    // nodes whose tree path goes through a newly blocked node or segment lose their distance
+    std::vector<uint32_t> affected;
+    auto cut = [&state, &affected](uint32_t v) {
+        if (state.parent[v] == NO_NODE) return; // the source, unreached, or already cut
+        state.dist[v] = INT_MAX;
+        state.parent[v] = NO_NODE;
+        state.parentArc[v] = NO_NODE;
+        affected.push_back(v);
+    };
+    for (size_t i = state.blockedNodes; i < blockedNodes.size(); i++) {
+        uint32_t x = blockedNodes[i]; // keeps its own distance, it just stops leading anywhere
+        for (uint32_t a = graph.firstArc(x); a < graph.endArc(x); a++) {
+            if (state.parent[graph.getArc(a).target] == x) cut(graph.getArc(a).target);
+        }
+    }
+    for (size_t i = state.blockedSegments; i < blockedArcs.size(); i++) {
+        uint32_t segment = graph.getArc(blockedArcs[i]).segment;
+        for (uint32_t v : {graph.getArc(blockedArcs[i]).target, graph.arcSource(blockedArcs[i])}) {
+            if (state.parentArc[v] != NO_NODE && graph.getArc(state.parentArc[v]).segment == segment) cut(v);
+        }
+    }
+    for (size_t i = 0; i < affected.size(); i++) {
+        uint32_t u = affected[i];
+        for (uint32_t a = graph.firstArc(u); a < graph.endArc(u); a++) {
+            if (state.parent[graph.getArc(a).target] == u) cut(graph.getArc(a).target);
+        }
     }
+    state.blockedNodes = blockedNodes.size();
+    state.blockedSegments = blockedArcs.size();
+    if (affected.empty()) return;
 
-    while (!s.empty()) {
-        path.push_back(s.top());
-        s.pop();
+    // distances only grew, so the rest of the tree is final; queued nodes are exactly the affected ones left
+    const TravelTimeProfiles &profiles = rn->getProfiles();
+    bool timed = state.departure >= 0;
+    IndexedPriorityQueue pq(state.dist, state.heapPos);
+    for (uint32_t v : affected) {
+        pq.insert(v);
+        if (stats) stats->heapInserts++;
+    }
+    for (uint32_t v : affected) {
+        for (uint32_t a = graph.firstArc(v); a < graph.endArc(v); a++) {
+            uint32_t u = graph.getArc(a).target;
+            if (pq.contains(u) || context.blockedNodes[u] || context.blockedSegments[graph.getArc(a).segment]) continue;
+            for (uint32_t b = graph.firstArc(u); b < graph.endArc(u); b++) {
+                if (graph.getArc(b).segment == graph.getArc(a).segment && graph.getArc(b).target == v) {
+                    if (stats) stats->edgesRelaxed++;
+                    if (timed) relaxAt(state, graph, profiles, u, b);
+                    else relax(state, graph, u, b, state.isDriving);
+                    break;
+                }
+            }
+        }
+        pq.decreaseKey(v);
+    }
+
+    while (!pq.empty()) {
+        uint32_t u = pq.extractMin();
+        if (stats) stats->extractMins++;
+        if (context.blockedNodes[u]) {
+            if (stats) stats->blockedHits++;
+            continue;
+        }
+        if (stats) stats->verticesSettled++;
+
+        for (uint32_t a = graph.firstArc(u); a < graph.endArc(u); a++) {
+            if (context.blockedSegments[graph.getArc(a).segment]) {
+                if (stats) stats->blockedHits++;
+                continue;
+            }
+            if (!pq.contains(graph.getArc(a).target)) continue;
+            if (stats) stats->edgesRelaxed++;
+            if (timed ? relaxAt(state, graph, profiles, u, a) : relax(state, graph, u, a, state.isDriving)) {
+                pq.decreaseKey(graph.getArc(a).target);
+                if (stats) stats->decreaseKeys++;
+            }
+        }
     }
-    return path;
 }
 
-void PathFinding::printSimplePath(std::vector<Location*> v, double weight, int call_mode, MultiStream out) {
-    if (v.empty()) {
-        out << "none\n";
-        return;
+bool PathFinding::reuseTree(RouteNetwork *rn, int src_id, bool mode) {
+    SearchState &state = rn->getSearchState();
+    SearchState &base = rn->getBaseSearchState();
+    uint32_t source = rn->getLocationById(src_id)->getIndex();
+    double departure = searchDeparture(rn, mode);
+    auto same = [source, mode, departure](const SearchState &tree) {
+        return tree.source == source && tree.isDriving == mode && tree.departure == departure;
+    };
+
+    if (!same(state)) {
+        if (!same(base)) return false;
+        state = base;
+    }
+    else if (state.blockedNodes == 0 && state.blockedSegments == 0 && rn->hasBlocked() && !same(base)) {
+        base = state; // kept for the next request from the same source, once these blocks are cleared
     }
+    repairTree(rn);
+    return true;
+}
+
+void PathFinding::boundedSearch(RouteNetwork *rn, const std::vector<std::pair<uint32_t, double>> &sources, bool isDriving, double budget,
+                                std::vector<std::pair<uint32_t, double>> &reached, const std::vector<char> *targets, size_t maxTargets) {
+    PhaseTimer timer(PHASE_SEARCH);
+    QueryCounters *stats = QueryStats::current();
+    if (stats) stats->searches++;
 
-    std::ostringstream output;
+    const RoutingGraph &graph = rn->getRoutingGraph();
+    SearchContext &context = rn->getSearchContext();
+    BoundedSearchState &state = context.bounded;
+    if (state.dist.size() != graph.getNumNodes()) {
+        state.dist.assign(graph.getNumNodes(), INT_MAX);
+        state.heapPos.assign(graph.getNumNodes(), 0);
+    }
+    else for (uint32_t v : state.touched) state.dist[v] = INT_MAX;
+    state.touched.clear();
+    reached.clear();
+
+    // nodes beyond the budget are never queued, and stopping early clears the queue, so heapPos is left all 0
+    IndexedPriorityQueue pq(state.dist, state.heapPos);
+    size_t targetsReached = 0;
+    for (auto [s, d] : sources) {
+        if (d > budget || d >= state.dist[s]) continue;
+        if (state.dist[s] == INT_MAX) state.touched.push_back(s);
+        state.dist[s] = d;
+        if (pq.contains(s)) pq.decreaseKey(s);
+        else pq.insert(s);
+        if (stats) stats->heapInserts++;
+    }
 
+    while (!pq.empty()) {
+        uint32_t u = pq.extractMin();
+        if (stats) stats->extractMins++;
+        reached.emplace_back(u, state.dist[u]);
+        if (targets != nullptr && (*targets)[u] && ++targetsReached == maxTargets) {
+            pq.clear();
+            break;
+        }
+        if (context.blockedNodes[u]) {
+            if (stats) stats->blockedHits++;
+            continue;
+        }
+        if (stats) stats->verticesSettled++;
 
-    for (auto s : v) {
-        switch (call_mode) {
-            case ID_MODE: {
-                output << s->getId() <<",";
-                break;
+        for (uint32_t a = graph.firstArc(u); a < graph.endArc(u); a++) {
+            if (context.blockedSegments[graph.getArc(a).segment]) {
+                if (stats) stats->blockedHits++;
+                continue;
             }
-            case CODE_MODE: {
-                output << s->getCode() <<",";
-                break;
+            if (stats) stats->edgesRelaxed++;
+            uint32_t v = graph.getArc(a).target;
+            double d = state.dist[u] + graph.getWeight(a, isDriving);
+            if (d > budget || d >= state.dist[v]) continue;
+            if (state.dist[v] == INT_MAX) {
+                state.touched.push_back(v);
+                state.dist[v] = d;
+                pq.insert(v);
+                if (stats) stats->heapInserts++;
             }
-            case NAME_MODE: {
-                output << s->getName() <<",";
-                break;
+            else {
+                state.dist[v] = d;
+                pq.decreaseKey(v);
+                if (stats) stats->decreaseKeys++;
             }
         }
+    }
+}
+
+uint32_t PathFinding::labelComponents(const RoutingGraph &graph, bool isDriving, std::vector<uint32_t> &labels) {
+    uint32_t n = graph.getNumNodes();
+    labels.assign(n, NO_NODE);
+    std::vector<uint32_t> queue;
+    queue.reserve(n);
+    uint32_t components = 0;
 
+    for (uint32_t s = 0; s < n; s++) {
+        if (labels[s] != NO_NODE) continue;
+        labels[s] = components;
+        queue.assign(1, s);
+        for (size_t head = 0; head < queue.size(); head++) {
+            uint32_t u = queue[head];
+            for (uint32_t a = graph.firstArc(u); a < graph.endArc(u); a++) {
+                uint32_t v = graph.getArc(a).target;
+                if (labels[v] != NO_NODE || graph.getWeight(a, isDriving) >= INT_MAX) continue;
+                labels[v] = components;
+                queue.push_back(v);
+            }
+        }
+        components++;
     }
+    return components;
+}
 
-    std::string result = output.str();
-    if (!result.empty()) {
-        result.pop_back();  // Remove the last comma
+double PathFinding::getDist(RouteNetwork *rn, Location *location) {
+    return rn->getSearchState().dist[location->getIndex()];
+}
+
+std::vector<Location*> PathFinding::getVectorPath(RouteNetwork *rn, const int &origin, const int &dest, double &weight, bool isDriving) {
+    PhaseTimer timer(PHASE_RECONSTRUCT);
+    const RoutingGraph &graph = rn->getRoutingGraph();
+    SearchState &state = rn->getSearchState();
+    uint32_t v = rn->getLocationById(dest)->getIndex();
+    uint32_t org = rn->getLocationById(origin)->getIndex();
+    std::vector<Location*> path;
+    std::stack<Location*> s;
+    s.push(rn->getLocationByIndex(v));
+    if (state.parent[v] == NO_NODE) return path;
+
+    // time-dependent segment times depend on when they are entered, which only the distances record
+    bool timed = state.departure >= 0;
+    if (timed) weight += state.dist[v];
+    while (v != NO_NODE && v != org) {
+        if (!timed) weight += graph.getWeight(state.parentArc[v], isDriving);
+
+        v = state.parent[v];
+        if (v != NO_NODE) s.push(rn->getLocationByIndex(v));
     }
-    out << result << "(" << weight << ")\n";
 
+    while (!s.empty()) {
+        path.push_back(s.top());
+        s.pop();
+    }
+    return path;
+}
+
+std::vector<int> PathFinding::getIdPath(const std::vector<Location*> &v) {
+    std::vector<int> ids;
+    ids.reserve(v.size());
+    for (auto s : v) ids.push_back(std::stoi(s->getId()));
+    return ids;
+}
 
+std::vector<Location*> PathFinding::getHierarchyPath(RouteNetwork *rn, int source, int dest, double &weight, bool mode) {
+    std::vector<uint32_t> nodes;
+    std::vector<double> weights;
+    Location* org = rn->getLocationById(source);
+    bool found;
+    {
+        PhaseTimer timer(PHASE_SEARCH);
+        QueryCounters *stats = QueryStats::current();
+        if (stats) stats->searches++;
+        found = rn->getHierarchy().query(org->getIndex(), rn->getLocationById(dest)->getIndex(), mode, rn->getSearchContext().hierarchy, nodes, weights);
+    }
+
+    PhaseTimer timer(PHASE_RECONSTRUCT);
+    std::vector<Location*> path;
+    if (!found) return path;
+    path.reserve(nodes.size() + 1);
+    path.push_back(org);
+    for (uint32_t v : nodes) path.push_back(rn->getLocationByIndex(v));
+    // summed from the destination like getVectorPath, so both give the same total for the same route
+    for (auto it = weights.rbegin(); it != weights.rend(); ++it) weight += *it;
+    return path;
 }
 
 std::vector<Location*> PathFinding::getPath(RouteNetwork *rn, int source, int dest, double &weight, bool mode) {
-    dijkstra(rn, source, mode);
+    if (rn->usesHierarchy() && !rn->hasBlocked() && searchDeparture(rn, mode) < 0) return getHierarchyPath(rn, source, dest, weight, mode);
+    if (!reuseTree(rn, source, mode)) dijkstra(rn, source, mode);
     return getVectorPath(rn, source, dest, weight, mode);
 }
 
-std::vector<Location*> PathFinding::mergeIncludePaths(std::vector<Location*> v1, std::vector<Location*> v2) {
+std::vector<Location*> PathFinding::mergeIncludePaths(const std::vector<Location*> &v1, const std::vector<Location*> &v2) {
     std::vector<Location*> path;
+    path.reserve(v1.size() + v2.size());
     for (auto s : v1) path.push_back(s);
     for (size_t i = 1; i < v2.size(); i++) path.push_back(v2[i]);
     return path;
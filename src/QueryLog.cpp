@@ -0,0 +1,62 @@
+#include "QueryLog.h"
+
+#include <sstream>
+
+#include "InputHandler.h"
+
+std::ofstream QueryLog::log_;
+std::mutex QueryLog::mutex_;
+int QueryLog::unflushed_ = 0;
+
+bool QueryLog::open(const std::string &path) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (log_.is_open()) log_.close();
+    log_.open(path, std::ios::app);
+    unflushed_ = 0;
+    return log_.is_open();
+}
+
+void QueryLog::close() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (log_.is_open()) log_.close();
+}
+
+bool QueryLog::isRecording() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return log_.is_open();
+}
+
+void QueryLog::record(const Request &request, std::chrono::steady_clock::time_point start) {
+    auto now = std::chrono::steady_clock::now();
+    double latency = std::chrono::duration<double, std::micro>(now - start).count();
+    auto started = std::chrono::system_clock::now() - std::chrono::duration_cast<std::chrono::system_clock::duration>(now - start);
+    long long timestamp = std::chrono::duration_cast<std::chrono::microseconds>(started.time_since_epoch()).count();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!log_.is_open()) return;
+    log_ << timestamp << " " << latency << " " << InputHandler::formatRequestLine(request) << "\n";
+    if (++unflushed_ >= QUERY_LOG_FLUSH_EVERY) {
+        log_.flush();
+        unflushed_ = 0;
+    }
+}
+
+bool QueryLog::load(const std::string &path, std::vector<LoggedRequest> &entries) {
+    std::ifstream log(path);
+    if (!log.is_open()) return false;
+
+    std::string line;
+    while (std::getline(log, line)) {
+        if (line.empty() || line[0] == '#') continue;
+
+        std::istringstream iss(line);
+        LoggedRequest entry;
+        std::string request_line;
+        if (!(iss >> entry.timestamp >> entry.latency >> request_line)) continue;
+
+        bool correct = true;
+        entry.request = InputHandler::parseRequestLine(request_line, correct);
+        if (correct) entries.push_back(entry);
+    }
+    return true;
+}
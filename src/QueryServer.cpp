@@ -0,0 +1,326 @@
+#include "QueryServer.h"
+
+#include <cerrno>
+#include <cstring>
+#include <exception>
+#include <sstream>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "InputHandler.h"
+#include "OutputSink.h"
+#include "QueryLog.h"
+#include "QueryStats.h"
+#include "RequestProcessor.h"
+#include "ResultFormatter.h"
+
+QueryServer::QueryServer(RouteNetwork &route_network, int workers, int format) : route_network_(route_network), workers_(workers), format_(format) {
+    if (workers_ < 1) workers_ = 1;
+}
+
+QueryServer::~QueryServer() {
+    for (auto &[fd, connection] : connections_) close(fd);
+    for (int fd : wake_fds_) if (fd >= 0) close(fd);
+    if (listen_fd_ >= 0) close(listen_fd_);
+    if (!socket_path_.empty()) unlink(socket_path_.c_str());
+}
+
+bool QueryServer::listenTcp(int port) {
+    listen_fd_ = socket(AF_INET, SOCK_STREAM, 0);
+    if (listen_fd_ < 0) return false;
+
+    int reuse = 1;
+    setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    if (bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 || listen(listen_fd_, SOMAXCONN) < 0) {
+        close(listen_fd_);
+        listen_fd_ = -1;
+        return false;
+    }
+    return true;
+}
+
+bool QueryServer::listenUnix(const std::string &path) {
+    sockaddr_un addr{};
+    if (path.size() >= sizeof(addr.sun_path)) return false;
+
+    listen_fd_ = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listen_fd_ < 0) return false;
+
+    addr.sun_family = AF_UNIX;
+    std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+    unlink(path.c_str());
+
+    if (bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 || listen(listen_fd_, SOMAXCONN) < 0) {
+        close(listen_fd_);
+        listen_fd_ = -1;
+        return false;
+    }
+    socket_path_ = path;
+    return true;
+}
+
+void QueryServer::run() {
+    if (pipe(wake_fds_) < 0) return;
+    for (int fd : {listen_fd_, wake_fds_[0], wake_fds_[1]}) fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+
+    std::vector<std::thread> pool;
+    for (int i = 0; i < workers_; i++) {
+        pool.emplace_back(&QueryServer::workerLoop, this);
+    }
+
+    std::vector<pollfd> fds;
+    std::vector<ServerConnection*> polled;
+    while (true) {
+        fds.assign({{listen_fd_, POLLIN, 0}, {wake_fds_[0], POLLIN, 0}});
+        polled.clear();
+        {
+            // stop reading from a client that sends faster than it is answered or reads its responses
+            std::lock_guard<std::mutex> lock(queue_mutex_);
+            for (auto &[fd, connection] : connections_) {
+                short events = 0;
+                if (!connection->closing && connection->commands.size() < SERVER_MAX_PENDING && connection->output.size() < SERVER_MAX_OUTPUT) events |= POLLIN;
+                if (!connection->output.empty() && !connection->broken) events |= POLLOUT;
+                // a socket waited on for nothing would still report hang-ups over and over
+                fds.push_back({events ? fd : -1, events, 0});
+                polled.push_back(connection.get());
+            }
+        }
+
+        if (poll(fds.data(), fds.size(), -1) < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+
+        if (fds[1].revents & POLLIN) {
+            char drain[256];
+            while (read(wake_fds_[0], drain, sizeof(drain)) > 0) {}
+        }
+
+        for (size_t i = 0; i < polled.size(); i++) {
+            ServerConnection &connection = *polled[i];
+            if (fds[i + 2].revents & (POLLIN | POLLHUP | POLLERR)) readConnection(connection);
+
+            std::lock_guard<std::mutex> lock(queue_mutex_);
+            sendOutput(connection);
+            bool done = connection.closing && !connection.busy && (connection.output.empty() || connection.broken);
+            if (done) {
+                close(connection.fd);
+                connections_.erase(connection.fd);
+            }
+        }
+
+        if (fds[0].revents & POLLIN) {
+            int fd = accept(listen_fd_, nullptr, nullptr);
+            if (fd < 0 && errno != EINTR && errno != EAGAIN && errno != EWOULDBLOCK && errno != ECONNABORTED) break;
+            if (fd >= 0) {
+                fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+                std::lock_guard<std::mutex> lock(queue_mutex_);
+                std::unique_ptr<ServerConnection> &connection = connections_[fd];
+                connection = std::make_unique<ServerConnection>();
+                connection->fd = fd;
+            }
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        stopping_ = true;
+    }
+    queue_cv_.notify_all();
+    for (auto &t : pool) t.join();
+}
+
+void QueryServer::workerLoop() {
+    while (true) {
+        ServerConnection *connection;
+        ServerCommand command;
+        bool dropped;
+        {
+            std::unique_lock<std::mutex> lock(queue_mutex_);
+            queue_cv_.wait(lock, [this] { return stopping_ || !ready_.empty(); });
+            if (stopping_) return;
+            connection = ready_.front();
+            ready_.pop();
+            // the commands of a connection whose client went away are dropped, not answered
+            dropped = connection->commands.empty();
+            if (!dropped) {
+                command = std::move(connection->commands.front());
+                connection->commands.pop_front();
+            }
+        }
+
+        std::string response = dropped ? "" : execute(command);
+
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex_);
+            if (!connection->broken) connection->output += response;
+            // one command per turn, so a connection with many requests waiting does not hold a worker
+            if (connection->commands.empty() || connection->broken) connection->busy = false;
+            else {
+                ready_.push(connection);
+                queue_cv_.notify_one();
+            }
+        }
+        char wake = 1;
+        if (write(wake_fds_[1], &wake, 1) < 0) {} // a full pipe already wakes the polling thread
+    }
+}
+
+void QueryServer::readConnection(ServerConnection &connection) {
+    char chunk[4096];
+    bool eof = false;
+    while (true) {
+        ssize_t n = read(connection.fd, chunk, sizeof(chunk));
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+        if (n <= 0) {
+            eof = true;
+            break;
+        }
+        connection.input.append(chunk, n);
+        if (n < ssize_t(sizeof(chunk))) break;
+    }
+
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    size_t start = 0, end;
+    while (!connection.closing && (end = connection.input.find('\n', start)) != std::string::npos) {
+        std::string line = connection.input.substr(start, end - start);
+        start = end + 1;
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+
+        std::string &block = connection.block;
+        if (block.empty() && line == "QUIT") connection.closing = true;
+        else if (block.empty() && line == "STATS") queueCommand(connection, COMMAND_STATS, "");
+        else if (block.empty() && line.rfind("UPDATE ", 0) == 0) queueCommand(connection, COMMAND_UPDATE, line.substr(7));
+        else if (block.empty() && line.find(';') != std::string::npos) queueCommand(connection, COMMAND_LINE, line);
+        else if (line.empty()) {
+            if (!block.empty()) queueCommand(connection, COMMAND_BLOCK, block);
+            block.clear();
+        }
+        else block += line + "\n";
+    }
+    connection.input.erase(0, start);
+
+    if (eof && !connection.closing) {
+        // a last request without its empty line, or without its line end, is still answered
+        std::string line = connection.input;
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (connection.block.empty() && line.find(';') != std::string::npos) queueCommand(connection, COMMAND_LINE, line);
+        else if (!connection.block.empty() || !line.empty()) {
+            queueCommand(connection, COMMAND_BLOCK, connection.block + line + (line.empty() ? "" : "\n"));
+        }
+        connection.input.clear();
+        connection.block.clear();
+    }
+    if (eof) connection.closing = true;
+}
+
+void QueryServer::queueCommand(ServerConnection &connection, int kind, const std::string &text) {
+    connection.commands.push_back({kind, text});
+    if (connection.busy) return;
+    connection.busy = true;
+    ready_.push(&connection);
+    queue_cv_.notify_one();
+}
+
+void QueryServer::sendOutput(ServerConnection &connection) {
+    size_t sent = 0;
+    while (!connection.broken && sent < connection.output.size()) {
+        ssize_t w = send(connection.fd, connection.output.data() + sent, connection.output.size() - sent, MSG_NOSIGNAL);
+        if (w < 0 && errno == EINTR) continue;
+        if (w < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+        if (w <= 0) {
+            // the client is gone, what it still had waiting is dropped
+            connection.broken = connection.closing = true;
+            connection.commands.clear();
+            break;
+        }
+        sent += w;
+    }
+    connection.output.erase(0, sent);
+}
+
+std::string QueryServer::execute(const ServerCommand &command) {
+    switch (command.kind) {
+        case COMMAND_STATS: {
+            std::ostringstream stats;
+            QueryStats::dump(stats);
+            return stats.str() + "\n";
+        }
+        case COMMAND_UPDATE: return applyUpdates(command.text);
+        case COMMAND_LINE: return answer(command.text, true);
+        default: return answer(command.text, false);
+    }
+}
+
+std::string QueryServer::applyUpdates(const std::string &update_file) {
+    int applied;
+    {
+        std::lock_guard<std::mutex> turn(update_mutex_);
+        std::unique_lock<std::shared_mutex> lock(network_mutex_);
+        applied = route_network_.applyUpdates(update_file);
+    }
+    if (applied < 0) return "Could not read " + update_file + "\n\n";
+    return "Updated " + std::to_string(applied) + " segments\n\n";
+}
+
+std::string QueryServer::answer(const std::string &request_text, bool single_line) {
+    auto start = std::chrono::steady_clock::now();
+    QueryScope scope;
+    bool correct = true;
+    Request request;
+    RouteResult result;
+    try {
+        if (single_line) request = InputHandler::parseRequestLine(request_text, correct);
+        else {
+            std::istringstream in(request_text);
+            request = InputHandler::parseRequest(in, correct);
+        }
+
+        if (!correct) {
+            result = RequestProcessor::newResult(request, RESULT_UNRESTRICTED_DRIVING);
+            result.status = ROUTE_INVALID;
+            result.message = "Input not within predefined standards";
+        }
+        else {
+            std::unique_lock<std::mutex> turn(update_mutex_);
+            std::shared_lock<std::shared_mutex> lock(network_mutex_);
+            turn.unlock();
+            try {
+                result = RequestProcessor::dispatchRequest(request, route_network_);
+            } catch (...) {
+                // the next request must not inherit the restrictions of this one
+                route_network_.clearBlocked();
+                route_network_.setDepartureTime(-1);
+                throw;
+            }
+        }
+    } catch (const std::exception &e) {
+        // one bad request must not stop the server, the client gets an error instead
+        correct = false;
+        result = RequestProcessor::newResult(request, RESULT_UNRESTRICTED_DRIVING);
+        result.status = ROUTE_INVALID;
+        result.message = std::string("Request failed: ") + e.what();
+    }
+    QueryStats::setType(RequestProcessor::getStatsType(result));
+
+    PhaseTimer timer(PHASE_OUTPUT);
+    OutputSink out(SINK_NONE);
+    out.setFormat(format_);
+    ResultFormatter::write(result, route_network_, ID_MODE, out);
+    if (format_ == FORMAT_TEXT) out << "\n";
+    if (correct) QueryLog::record(request, start);
+    return out.str();
+}
@@ -0,0 +1,128 @@
+#include "QueryStats.h"
+
+#include <cmath>
+#include <iomanip>
+
+bool QueryStats::enabled_ = false;
+thread_local QueryCounters *QueryStats::current_ = nullptr;
+thread_local std::string *QueryStats::current_type_ = nullptr;
+std::mutex QueryStats::mutex_;
+std::map<std::string, std::map<std::string, Histogram>> QueryStats::histograms_;
+
+/************************* Histogram  **************************/
+
+void Histogram::add(double value) {
+    if (value < 0) value = 0;
+    int bucket = value < 1 ? 0 : std::min(HISTOGRAM_BUCKETS - 1, int(std::log2(value)) + 1);
+    buckets_[bucket]++;
+
+    if (count_ == 0 || value < min_) min_ = value;
+    if (count_ == 0 || value > max_) max_ = value;
+    count_++;
+    sum_ += value;
+}
+
+double Histogram::percentile(double p) const {
+    if (count_ == 0) return 0;
+    unsigned long rank = (unsigned long) std::ceil(p / 100.0 * count_);
+    if (rank == 0) rank = 1;
+
+    unsigned long seen = 0;
+    for (int i = 0; i < HISTOGRAM_BUCKETS; i++) {
+        seen += buckets_[i];
+        if (seen >= rank) return std::min(max_, std::ldexp(1.0, i));
+    }
+    return max_;
+}
+
+void Histogram::print(const std::string &name, std::ostream &out) const {
+    out << "  " << std::left << std::setw(22) << name << std::right
+    << " n=" << count_
+    << " mean=" << (count_ ? sum_ / count_ : 0)
+    << " min=" << min_
+    << " p50<=" << percentile(50)
+    << " p90<=" << percentile(90)
+    << " p99<=" << percentile(99)
+    << " max=" << max_ << "\n";
+}
+
+/************************* QueryStats  **************************/
+
+void QueryStats::setEnabled(bool enabled) {
+    enabled_ = enabled;
+}
+
+bool QueryStats::isEnabled() {
+    return enabled_;
+}
+
+QueryCounters *QueryStats::current() {
+    return current_;
+}
+
+void QueryStats::setType(const std::string &type) {
+    if (current_type_ != nullptr) *current_type_ = type;
+}
+
+void QueryStats::record(const std::string &type, const QueryCounters &counters, double total_us) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto &h = histograms_[type];
+    h["total_us"].add(total_us);
+    h["parse_us"].add(counters.phaseTime[PHASE_PARSE]);
+    h["search_us"].add(counters.phaseTime[PHASE_SEARCH]);
+    h["reconstruct_us"].add(counters.phaseTime[PHASE_RECONSTRUCT]);
+    h["output_us"].add(counters.phaseTime[PHASE_OUTPUT]);
+    h["searches"].add(counters.searches);
+    h["heap_inserts"].add(counters.heapInserts);
+    h["decrease_keys"].add(counters.decreaseKeys);
+    h["extract_mins"].add(counters.extractMins);
+    h["edges_relaxed"].add(counters.edgesRelaxed);
+    h["vertices_settled"].add(counters.verticesSettled);
+    h["blocked_hits"].add(counters.blockedHits);
+}
+
+void QueryStats::dump(std::ostream &out) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (histograms_.empty()) {
+        out << "No measured queries" << (enabled_ ? "" : " (statistics are disabled, start with --stats)") << "\n";
+        return;
+    }
+    for (auto &type : histograms_) {
+        out << type.first << ":\n";
+        for (auto &metric : type.second) metric.second.print(metric.first, out);
+    }
+}
+
+void QueryStats::reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    histograms_.clear();
+}
+
+/************************* QueryScope  **************************/
+
+QueryScope::QueryScope(const std::string &type) : type_(type) {
+    if (!QueryStats::enabled_ || QueryStats::current_ != nullptr) return;
+    owner_ = true;
+    QueryStats::current_ = &counters_;
+    QueryStats::current_type_ = &type_;
+    start_ = std::chrono::steady_clock::now();
+}
+
+QueryScope::~QueryScope() {
+    if (!owner_) return;
+    double total_us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start_).count();
+    QueryStats::current_ = nullptr;
+    QueryStats::current_type_ = nullptr;
+    QueryStats::record(type_, counters_, total_us);
+}
+
+/************************* PhaseTimer  **************************/
+
+PhaseTimer::PhaseTimer(int phase) : counters_(QueryStats::current()), phase_(phase) {
+    if (counters_ != nullptr) start_ = std::chrono::steady_clock::now();
+}
+
+PhaseTimer::~PhaseTimer() {
+    if (counters_ == nullptr) return;
+    counters_->phaseTime[phase_] += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start_).count();
+}
@@ -1,100 +1,209 @@
 #include "RequestProcessor.h"
 
-#include <fstream>
+#include <algorithm>
+#include <map>
 
 #include "PathFinding.h"
+#include "ResultFormatter.h"
 
 #include <iostream>
 #include <ostream>
 
-#include "MultiStream.h"
+#include "OutputSink.h"
+#include "QueryLog.h"
+#include "QueryStats.h"
+#include "ThreadPool.h"
 
+typedef struct {
+    double dist;
+    std::vector<Location*> path;
+} Path;
+
+typedef struct {
+    double walk;
+    double total;
+    Location* parking;
+} Candidate;
+
+OutputSink *RequestProcessor::output_sink_ = nullptr;
+
+void RequestProcessor::setOutputSink(OutputSink *sink) {
+    output_sink_ = sink;
+}
+
+OutputSink &RequestProcessor::getOutputSink() {
+    static OutputSink session_sink;
+    if (output_sink_ != nullptr) return *output_sink_;
+    return session_sink;
+}
 
 void RequestProcessor::processRequest(Request &request, RouteNetwork &route_network, int call_mode) {
-    std::ofstream outFile("../output/output.txt");
-    if (!outFile) {
-        std::cerr << "Error opening file!" << std::endl;
-        return;
+    OutputSink &out = getOutputSink();
+    auto start = std::chrono::steady_clock::now();
+    QueryScope scope;
+
+    RouteResult result = dispatchRequest(request, route_network);
+    QueryStats::setType(getStatsType(result));
+
+    {
+        PhaseTimer timer(PHASE_OUTPUT);
+        ResultFormatter::write(result, route_network, call_mode, out);
+        out.endRequest();
     }
-    MultiStream out(std::cout, outFile);
+    QueryLog::record(request, start);
+}
 
-    if (request.mode == "driving") {
-        if (!request.avoidNodes.empty() || !request.avoidSegments.empty() || request.includeNode >= 0) {
-            processRestrictedDriving(request, route_network, call_mode, out);
-        }
-        else processUnrestrictedDriving(request, route_network, call_mode, out);
+void RequestProcessor::processBatch(std::vector<Request> &requests, RouteNetwork &route_network, int call_mode) {
+    OutputSink &out = getOutputSink();
+
+    // one shortest-path tree answers every destination of the same (source, mode) bucket;
+    // time-dependent requests run on their own, since their trees also depend on the departure time
+    auto shared = [&route_network](const Request &request) {
+        return isUnrestrictedDriving(request) && request.departureTime < 0 && route_network.getLocationById(request.src) != nullptr
+            && route_network.getLocationById(request.dest) != nullptr;
+    };
+    std::map<std::pair<int, std::string>, std::vector<size_t>> buckets;
+    for (size_t i = 0; i < requests.size(); i++) {
+        if (shared(requests[i])) buckets[std::make_pair(requests[i].src, requests[i].mode)].push_back(i);
     }
-    else if (request.mode == "driving-walking") processDrivingWalking(request, route_network, call_mode, out);
-    else std::cout << "Invalid input format\n";
 
-    outFile.close();
+    // every path is extracted before any request runs its own search, since that overwrites the tree;
+    // the buckets are searched on the thread pool, each worker in its own search context
+    std::vector<const decltype(buckets)::value_type*> jobs;
+    for (auto &bucket : buckets) jobs.push_back(&bucket);
+    std::vector<Path> best(requests.size());
+    ThreadPool &pool = ThreadPool::shared();
+    pool.parallelFor(0, jobs.size(), [&](size_t j) {
+        QueryScope scope("batch-shared-tree");
+        route_network.setDepartureTime(-1);
+        PathFinding::dijkstra(&route_network, jobs[j]->first.first, DRIVING_MODE);
+        for (size_t i : jobs[j]->second) {
+            double w = 0;
+            best[i].path = PathFinding::getVectorPath(&route_network, requests[i].src, requests[i].dest, w, DRIVING_MODE);
+            best[i].dist = w;
+        }
+    });
+    if (pool.size() > 1) route_network.getSearchState().source = NO_NODE; // which tree is left depends on the scheduling
+
+    for (size_t i = 0; i < requests.size(); i++) {
+        Request &request = requests[i];
+        auto start = std::chrono::steady_clock::now();
+        QueryScope scope;
+        RouteResult result;
+        if (shared(request)) {
+            route_network.setDepartureTime(-1);
+            result = processUnrestrictedDriving(request, route_network, best[i].path, best[i].dist);
+        }
+        else result = dispatchRequest(request, route_network);
+        QueryStats::setType(getStatsType(result));
+
+        {
+            PhaseTimer timer(PHASE_OUTPUT);
+            ResultFormatter::write(result, route_network, call_mode, out);
+            out.endRequest();
+        }
+        QueryLog::record(request, start);
+    }
 }
 
-void RequestProcessor::processUnrestrictedDriving(Request &request, RouteNetwork &route_network, int call_mode, MultiStream out) {
+std::string RequestProcessor::getStatsType(const RouteResult &result) {
+    if (result.status == ROUTE_INVALID) return "invalid";
+    return ResultFormatter::getKindName(result.kind);
+}
 
+RouteResult RequestProcessor::dispatchRequest(Request &request, RouteNetwork &route_network) {
+    route_network.setDepartureTime(request.departureTime);
+    if (request.mode == "reachability") return processReachability(request, route_network);
+    if (request.mode == "nearest-parking") return processNearestParking(request, route_network);
+    if (request.mode == "distance") return processDistance(request, route_network);
+
+    if (route_network.getLocationById(request.src) == nullptr || route_network.getLocationById(request.dest) == nullptr) {
+        RouteResult result = newResult(request, RESULT_UNRESTRICTED_DRIVING);
+        result.status = ROUTE_INVALID;
+        result.message = "Source " + std::to_string(request.src) + " or destination " + std::to_string(request.dest) + " doesn't exist.";
+        return result;
+    }
 
-    switch (call_mode) {
-        case ID_MODE: {
-            out << "Source:" << request.src << std::endl
-            << "Destination:" << request.dest << std::endl;
-            break;
-        }
-        case CODE_MODE: {
-            out << "Source:" << route_network.getLocationById(request.src)->getCode() << std::endl
-            << "Destination:" <<  route_network.getLocationById(request.dest)->getCode() << std::endl;
-            break;
-        }
-        case NAME_MODE: {
-            out << "Source:" << route_network.getLocationById(request.src)->getName() << std::endl
-            << "Destination:" <<  route_network.getLocationById(request.dest)->getName() << std::endl;
-            break;
+    if (request.mode == "driving") {
+        if (!isUnrestrictedDriving(request)) {
+            return processRestrictedDriving(request, route_network);
         }
+        return processUnrestrictedDriving(request, route_network);
     }
+    if (request.mode == "driving-walking") return processDrivingWalking(request, route_network);
+    if (request.mode == "driving-walking-pareto") return processDrivingWalkingPareto(request, route_network);
+
+    RouteResult result = newResult(request, RESULT_UNRESTRICTED_DRIVING);
+    result.status = ROUTE_INVALID;
+    result.message = "Invalid input format";
+    return result;
+}
+
+bool RequestProcessor::isUnrestrictedDriving(const Request &request) {
+    return request.mode == "driving" && request.avoidNodes.empty() && request.avoidSegments.empty() && request.includeNode < 0;
+}
 
-    out << "BestDrivingRoute:" ;
+RouteResult RequestProcessor::newResult(const Request &request, int kind) {
+    RouteResult result;
+    result.kind = kind;
+    result.src = request.src;
+    result.dest = request.dest;
+    result.maxWalkTime = request.maxWalkTime;
+    result.travelMode = request.travelMode;
+    result.maxTime = request.maxTime;
+    result.count = request.count;
+    result.departureTime = request.departureTime;
+    return result;
+}
 
+RouteResult RequestProcessor::processUnrestrictedDriving(Request &request, RouteNetwork &route_network) {
+    if (!route_network.areConnected(request.src, request.dest, DRIVING_MODE)) {
+        return processUnrestrictedDriving(request, route_network, {}, 0);
+    }
 
     double w=0;
-    std::vector<Location*> v;
+    std::vector<Location*> v = PathFinding::getPath(&route_network, request.src, request.dest, w, DRIVING_MODE);
+    return processUnrestrictedDriving(request, route_network, v, w);
+}
 
-    v = PathFinding::getPath(&route_network, request.src, request.dest, w, DRIVING_MODE);
-    PathFinding::printSimplePath(v, w, call_mode, out);
+RouteResult RequestProcessor::processUnrestrictedDriving(Request &request, RouteNetwork &route_network, const std::vector<Location*> &best, double best_weight) {
+    RouteResult result = newResult(request, RESULT_UNRESTRICTED_DRIVING);
+    result.route.path = PathFinding::getIdPath(best);
+    result.route.weight = best_weight;
 
-    if (v.empty()) return;
+    if (best.empty()) {
+        result.status = ROUTE_NOT_FOUND;
+        return result;
+    }
 
     //block intermediate blocks
-    for (int i = 1; i < int(v.size())-1; i++) {
-        route_network.blockNode(std::stoi(v[i]->getId()));
+    for (int i = 1; i < int(best.size())-1; i++) {
+        route_network.blockNode(result.route.path[i]);
     }
 
-    out << "AlternativeDrivingRoute:";
-
-    w=0;
-    v = PathFinding::getPath(&route_network, request.src, request.dest, w, DRIVING_MODE);
-    PathFinding::printSimplePath(v, w, call_mode, out);
+    double w=0;
+    std::vector<Location*> v = PathFinding::getPath(&route_network, request.src, request.dest, w, DRIVING_MODE);
+    result.alternative.path = PathFinding::getIdPath(v);
+    result.alternative.weight = w;
     route_network.clearBlocked();
 
+    return result;
 }
 
-void RequestProcessor::processRestrictedDriving(Request &request, RouteNetwork &route_network, int call_mode, MultiStream out) {
-    switch (call_mode) {
-        case ID_MODE: {
-            out << "Source:" << request.src << std::endl
-            << "Destination:" << request.dest << std::endl;
-            break;
-        }
-        case CODE_MODE: {
-            out << "Source:" << route_network.getLocationById(request.src)->getCode() << std::endl
-            << "Destination:" <<  route_network.getLocationById(request.dest)->getCode() << std::endl;
-            break;
-        }
-        case NAME_MODE: {
-            out << "Source:" << route_network.getLocationById(request.src)->getName() << std::endl
-            << "Destination:" <<  route_network.getLocationById(request.dest)->getName() << std::endl;
-            break;
-        }
+RouteResult RequestProcessor::processRestrictedDriving(Request &request, RouteNetwork &route_network) {
+    RouteResult result = newResult(request, RESULT_RESTRICTED_DRIVING);
+
+    // avoiding nodes and segments can only disconnect more, so unconnected locations need no search,
+    // and neither do requests avoiding a cut node or bridge between them
+    bool connected = request.includeNode == -1
+        ? route_network.areConnected(request.src, request.dest, DRIVING_MODE)
+        : route_network.areConnected(request.src, request.includeNode, DRIVING_MODE)
+          && route_network.areConnected(request.includeNode, request.dest, DRIVING_MODE);
+    if (!connected || (request.includeNode == -1
+        && route_network.avoidSeparates(request.src, request.dest, request.avoidNodes, request.avoidSegments))) {
+        result.status = ROUTE_NOT_FOUND;
+        return result;
     }
-    out<< "RestrictedDrivingRoute:" ;
 
     //update route_network blocked
     if (!request.avoidNodes.empty() || !request.avoidSegments.empty()) {
@@ -108,9 +217,11 @@ void RequestProcessor::processRestrictedDriving(Request &request, RouteNetwork &
     std::vector<Location*> v;
     if (request.includeNode == -1) {
         v = PathFinding::getPath(&route_network, request.src, request.dest, w, DRIVING_MODE);
-        PathFinding::printSimplePath(v, w, call_mode, out);
         route_network.clearBlocked();
-        return;
+        result.route.path = PathFinding::getIdPath(v);
+        result.route.weight = w;
+        if (v.empty()) result.status = ROUTE_NOT_FOUND;
+        return result;
     }
 
     route_network.clearBlocked();
@@ -118,25 +229,21 @@ void RequestProcessor::processRestrictedDriving(Request &request, RouteNetwork &
     w=0;
     std::vector<Location*> v2;
     v = PathFinding::getPath(&route_network, request.src, request.includeNode, w, DRIVING_MODE);
+    // the second leg leaves the include node when the first one arrives there
+    if (request.departureTime >= 0) route_network.setDepartureTime(request.departureTime + w);
     v2 = PathFinding::getPath(&route_network, request.includeNode, request.dest, w, DRIVING_MODE);
+    route_network.setDepartureTime(request.departureTime);
     if (v.empty() || v2.empty()) {
-        out << "none\n";
-        return;
+        result.status = ROUTE_NOT_FOUND;
+        return result;
     }
 
-    std::vector<Location*> path = PathFinding::mergeIncludePaths(v, v2);
-    PathFinding::printSimplePath(path, w, call_mode, out);
-
+    result.route.path = PathFinding::getIdPath(PathFinding::mergeIncludePaths(v, v2));
+    result.route.weight = w;
+    return result;
 }
 
-
-
-typedef struct {
-    double dist;
-    std::vector<Location*> path;
-} Path;
-
-void RequestProcessor::processDrivingWalking(Request &request, RouteNetwork &route_network, int call_mode, MultiStream out) {
+RouteResult RequestProcessor::processDrivingWalking(Request &request, RouteNetwork &route_network) {
     if (!request.avoidNodes.empty() || !request.avoidSegments.empty()) {
         for (int id : request.avoidNodes) route_network.blockNode(id);
         for (std::pair<int, int> p : request.avoidSegments) {
@@ -148,11 +255,13 @@ void RequestProcessor::processDrivingWalking(Request &request, RouteNetwork &rou
     std::unordered_map<Location*, Path> walkingPath;
     std::unordered_map<Location*, Path> drivingPath;
 
+    uint32_t src = route_network.getLocationById(request.src)->getIndex();
     PathFinding::dijkstra(&route_network, request.dest, WALKING_MODE);
     for (auto v : route_network.getLocationSet()) {
         auto* l = static_cast<Location*>(v);
-        if (route_network.isNodeBlocked(l)) continue;
-        if (l->getCanPark() && l->getDist() < request.maxWalkTime) {
+        if (route_network.isNodeBlocked(l->getIndex())) continue;
+        if (!route_network.sameComponent(src, l->getIndex(), DRIVING_MODE)) continue;
+        if (l->getCanPark() && PathFinding::getDist(&route_network, l) < request.maxWalkTime) {
             Path path;
             double w=0;
             path.path = PathFinding::getVectorPath(&route_network, request.dest, std::stoi(l->getId()), w, WALKING_MODE);
@@ -165,6 +274,7 @@ void RequestProcessor::processDrivingWalking(Request &request, RouteNetwork &rou
 
    PathFinding::dijkstra(&route_network, request.src, DRIVING_MODE);
     for (auto p : validParkingNodes) {
+        if (PathFinding::getDist(&route_network, p) >= INT_MAX) continue; // cut off by the avoided nodes or segments
         Path path;
         double w=0;
         path.path = PathFinding::getVectorPath(&route_network, request.src, std::stoi(p->getId()), w, DRIVING_MODE);
@@ -176,6 +286,7 @@ void RequestProcessor::processDrivingWalking(Request &request, RouteNetwork &rou
     Location* bestParking = nullptr;
 
     for (auto p : validParkingNodes) {
+        if (drivingPath.find(p) == drivingPath.end()) continue;
         double totalTime = drivingPath[p].dist + walkingPath[p].dist;
         if (totalTime < minTotalTime ||
             ((totalTime == minTotalTime) && walkingPath[p].dist > walkingPath[bestParking].dist)) {
@@ -186,61 +297,158 @@ void RequestProcessor::processDrivingWalking(Request &request, RouteNetwork &rou
 
     route_network.clearBlocked();
 
-    switch (call_mode) {
-        case ID_MODE: {
-            out << "Source:" << request.src << std::endl
-            << "Destination:" << request.dest << std::endl;
-            break;
-        }
-        case CODE_MODE: {
-            out << "Source:" << route_network.getLocationById(request.src)->getCode() << std::endl
-            << "Destination:" <<  route_network.getLocationById(request.dest)->getCode() << std::endl;
-            break;
-        }
-        case NAME_MODE: {
-            out << "Source:" << route_network.getLocationById(request.src)->getName() << std::endl
-            << "Destination:" <<  route_network.getLocationById(request.dest)->getName() << std::endl;
-            break;
-        }
-    }
-    out << "DrivingRoute:";
+    RouteResult result = newResult(request, RESULT_DRIVING_WALKING);
 
     if (bestParking == nullptr) {
-        out << "none\n"
-        << "ParkingNode:none\n"
-        << "WalkingRoute:none\n"
-        << "TotalTime:none\n"
-        << "Message: No possible route with max. walking time of " << request.maxWalkTime << " minutes.\n";
-        return;
+        result.status = ROUTE_NOT_FOUND;
+        result.message = "No possible route with max. walking time of " + std::to_string(request.maxWalkTime) + " minutes.";
+        return result;
     }
 
-    std::vector<Location*> v1 = drivingPath[bestParking].path;
-    PathFinding::printSimplePath(v1, drivingPath[bestParking].dist, call_mode, out);
+    result.route.path = PathFinding::getIdPath(drivingPath[bestParking].path);
+    result.route.weight = drivingPath[bestParking].dist;
+    result.parkingNode = std::stoi(bestParking->getId());
+
+    std::vector<Location*> v2 = walkingPath[bestParking].path;
+    reverse(v2.begin(), v2.end());
+    result.walking.path = PathFinding::getIdPath(v2);
+    result.walking.weight = walkingPath[bestParking].dist;
+    result.totalTime = minTotalTime;
 
+    return result;
+}
 
-    switch (call_mode) {
-        case ID_MODE: {
-            out << "Parking Node:" << bestParking->getId() << std::endl;
-            break;
-        }
-        case CODE_MODE: {
-            out << "Parking Node:" << bestParking->getCode() << std::endl;
-            break;
+RouteResult RequestProcessor::processDrivingWalkingPareto(Request &request, RouteNetwork &route_network) {
+    if (!request.avoidNodes.empty() || !request.avoidSegments.empty()) {
+        for (int id : request.avoidNodes) route_network.blockNode(id);
+        for (std::pair<int, int> p : request.avoidSegments) {
+            route_network.blockEdge(p.first, p.second);
         }
-        case NAME_MODE: {
-            out << "Parking Node:" << bestParking->getName() << std::endl;
-            break;
+    }
+
+    std::vector<Candidate> candidates;
+
+    uint32_t src = route_network.getLocationById(request.src)->getIndex();
+    PathFinding::dijkstra(&route_network, request.dest, WALKING_MODE);
+    for (auto v : route_network.getLocationSet()) {
+        auto* l = static_cast<Location*>(v);
+        if (route_network.isNodeBlocked(l->getIndex())) continue;
+        if (!route_network.sameComponent(src, l->getIndex(), DRIVING_MODE)) continue;
+        if (l->getCanPark() && PathFinding::getDist(&route_network, l) < request.maxWalkTime) {
+            candidates.push_back({PathFinding::getDist(&route_network, l), 0, l});
         }
     }
+    // the walking routes of the options are read once they are known, after the driving search reused the arrays
+    SearchState walking = route_network.getSearchState();
+
+    PathFinding::dijkstra(&route_network, request.src, DRIVING_MODE);
+    std::vector<Candidate> frontier;
+    for (Candidate &c : candidates) c.total = c.walk + PathFinding::getDist(&route_network, c.parking);
+    std::sort(candidates.begin(), candidates.end(), [](const Candidate &a, const Candidate &b) {
+        if (a.walk != b.walk) return a.walk < b.walk;
+        if (a.total != b.total) return a.total < b.total;
+        return a.parking->getIndex() < b.parking->getIndex();
+    });
+    // by increasing walking time, a candidate is only worth it if it arrives sooner than every one walking less
+    for (const Candidate &c : candidates) {
+        if (c.total >= INT_MAX) continue; // cut off by the avoided nodes or segments
+        if (frontier.empty() || c.total < frontier.back().total) frontier.push_back(c);
+    }
+    if (frontier.size() > MAX_PARETO_OPTIONS) {
+        std::vector<Candidate> kept;
+        for (size_t i = 0; i < MAX_PARETO_OPTIONS; i++) kept.push_back(frontier[i * (frontier.size() - 1) / (MAX_PARETO_OPTIONS - 1)]);
+        frontier.swap(kept);
+    }
+    std::reverse(frontier.begin(), frontier.end());
+
+    RouteResult result = newResult(request, RESULT_PARETO);
+    for (const Candidate &c : frontier) {
+        RouteOption option;
+        double w = 0;
+        option.driving.path = PathFinding::getIdPath(PathFinding::getVectorPath(&route_network, request.src, std::stoi(c.parking->getId()), w, DRIVING_MODE));
+        option.driving.weight = w;
+        option.parkingNode = std::stoi(c.parking->getId());
+        result.options.push_back(option);
+    }
 
+    std::swap(route_network.getSearchState(), walking);
+    for (RouteOption &option : result.options) {
+        double w = 0;
+        std::vector<Location*> v = PathFinding::getVectorPath(&route_network, request.dest, option.parkingNode, w, WALKING_MODE);
+        reverse(v.begin(), v.end());
+        option.walking.path = PathFinding::getIdPath(v);
+        option.walking.weight = w;
+        option.totalTime = option.driving.weight + w;
+    }
 
-    out << "WalkingRoute:";
-    std::vector<Location*> v2 = walkingPath[bestParking].path;
-    reverse(v2.begin(), v2.end());
-    PathFinding::printSimplePath(v2, walkingPath[bestParking].dist, call_mode, out);
+    route_network.clearBlocked();
+
+    if (result.options.empty()) {
+        result.status = ROUTE_NOT_FOUND;
+        result.message = "No possible route with max. walking time of " + std::to_string(request.maxWalkTime) + " minutes.";
+    }
+    return result;
+}
+
+RouteResult RequestProcessor::processReachability(Request &request, RouteNetwork &route_network) {
+    RouteResult result = newResult(request, RESULT_REACHABILITY);
+    Location* src = route_network.getLocationById(request.src);
+    if (src == nullptr) {
+        result.status = ROUTE_INVALID;
+        result.message = "Source " + std::to_string(request.src) + " doesn't exist.";
+        return result;
+    }
 
-    out << "TotalTime:" << minTotalTime << std::endl;
+    std::vector<std::pair<uint32_t, double>> reached;
+    if (request.travelMode == "driving-walking") {
+        // every parking location reached by car starts the walk with the time spent driving
+        std::vector<std::pair<uint32_t, double>> parking;
+        PathFinding::boundedSearch(&route_network, {{src->getIndex(), 0}}, DRIVING_MODE, request.maxTime, reached);
+        for (auto [v, time] : reached) {
+            if (route_network.getLocationByIndex(v)->getCanPark()) parking.emplace_back(v, time);
+        }
+        PathFinding::boundedSearch(&route_network, parking, WALKING_MODE, request.maxTime, reached);
+    }
+    else {
+        bool mode = request.travelMode == "driving" ? DRIVING_MODE : WALKING_MODE;
+        PathFinding::boundedSearch(&route_network, {{src->getIndex(), 0}}, mode, request.maxTime, reached);
+    }
 
+    for (auto [v, time] : reached) {
+        Location* l = route_network.getLocationByIndex(v);
+        if (request.parkingOnly && !l->getCanPark()) continue;
+        result.reached.push_back({std::stoi(l->getId()), time});
+    }
+    if (result.reached.empty()) result.status = ROUTE_NOT_FOUND;
+    return result;
 }
 
+RouteResult RequestProcessor::processNearestParking(Request &request, RouteNetwork &route_network) {
+    RouteResult result = newResult(request, RESULT_NEAREST_PARKING);
+    if (route_network.getLocationById(request.src) == nullptr) {
+        result.status = ROUTE_INVALID;
+        result.message = "Source " + std::to_string(request.src) + " doesn't exist.";
+        return result;
+    }
 
+    bool mode = request.travelMode == "driving" ? DRIVING_MODE : WALKING_MODE;
+    for (auto [l, time] : route_network.findNearestParking(request.src, request.count, mode)) {
+        result.reached.push_back({std::stoi(l->getId()), time});
+    }
+    if (result.reached.empty()) result.status = ROUTE_NOT_FOUND;
+    return result;
+}
+
+RouteResult RequestProcessor::processDistance(Request &request, RouteNetwork &route_network) {
+    RouteResult result = newResult(request, RESULT_DISTANCE);
+    if (route_network.getLocationById(request.src) == nullptr || route_network.getLocationById(request.dest) == nullptr) {
+        result.status = ROUTE_INVALID;
+        result.message = "Source " + std::to_string(request.src) + " or destination " + std::to_string(request.dest) + " doesn't exist.";
+        return result;
+    }
+
+    bool mode = request.travelMode == "driving" ? DRIVING_MODE : WALKING_MODE;
+    result.totalTime = route_network.getTravelTime(request.src, request.dest, mode);
+    if (result.totalTime >= INT_MAX) result.status = ROUTE_NOT_FOUND;
+    return result;
+}
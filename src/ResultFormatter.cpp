@@ -0,0 +1,302 @@
+#include "ResultFormatter.h"
+
+#include <iomanip>
+#include <sstream>
+
+#include "InputHandler.h"
+
+const char *ResultFormatter::getKindName(int kind) {
+    static const char *kinds[] = {"unrestricted-driving", "restricted-driving", "driving-walking", "reachability", "nearest-parking", "driving-walking-pareto", "distance"};
+    return kinds[kind];
+}
+
+void ResultFormatter::write(const RouteResult &result, RouteNetwork &route_network, int call_mode, OutputSink &out) {
+    switch (out.getFormat()) {
+        case FORMAT_JSONL: {
+            writeJsonLine(result, out);
+            break;
+        }
+        case FORMAT_BINARY: {
+            writeBinary(result, out);
+            break;
+        }
+        default: {
+            writeText(result, route_network, call_mode, out);
+            break;
+        }
+    }
+}
+
+void ResultFormatter::writeLocation(int id, RouteNetwork &route_network, int call_mode, OutputSink &out) {
+    switch (call_mode) {
+        case ID_MODE: {
+            out << id;
+            break;
+        }
+        case CODE_MODE: {
+            out << route_network.getLocationById(id)->getCode();
+            break;
+        }
+        case NAME_MODE: {
+            out << route_network.getLocationById(id)->getName();
+            break;
+        }
+    }
+}
+
+void ResultFormatter::writeTextPath(const PathResult &path, RouteNetwork &route_network, int call_mode, OutputSink &out) {
+    if (path.path.empty()) {
+        out << "none\n";
+        return;
+    }
+
+    for (size_t i = 0; i < path.path.size(); i++) {
+        if (i > 0) out << ",";
+        writeLocation(path.path[i], route_network, call_mode, out);
+    }
+    out << "(" << path.weight << ")\n";
+}
+
+void ResultFormatter::writeText(const RouteResult &result, RouteNetwork &route_network, int call_mode, OutputSink &out) {
+    if (result.status == ROUTE_INVALID) {
+        out << result.message << "\n";
+        return;
+    }
+
+    out << "Source:";
+    writeLocation(result.src, route_network, call_mode, out);
+    if (result.kind == RESULT_REACHABILITY || result.kind == RESULT_NEAREST_PARKING) {
+        out << "\nTravelMode:" << result.travelMode;
+        if (result.kind == RESULT_REACHABILITY) out << "\nMaxTime:" << result.maxTime << "\nReachable:";
+        else out << "\nCount:" << result.count << "\nNearestParking:";
+        if (result.reached.empty()) out << "none";
+        for (size_t i = 0; i < result.reached.size(); i++) {
+            if (i > 0) out << ",";
+            writeLocation(result.reached[i].id, route_network, call_mode, out);
+            out << "(" << result.reached[i].time << ")";
+        }
+        out << "\n";
+        return;
+    }
+    out << "\nDestination:";
+    writeLocation(result.dest, route_network, call_mode, out);
+    out << "\n";
+    if (result.departureTime >= 0) out << "DepartureTime:" << InputHandler::formatClockTime(result.departureTime) << "\n";
+
+    switch (result.kind) {
+        case RESULT_UNRESTRICTED_DRIVING: {
+            out << "BestDrivingRoute:";
+            writeTextPath(result.route, route_network, call_mode, out);
+            if (result.route.path.empty()) break;
+            out << "AlternativeDrivingRoute:";
+            writeTextPath(result.alternative, route_network, call_mode, out);
+            break;
+        }
+        case RESULT_RESTRICTED_DRIVING: {
+            out << "RestrictedDrivingRoute:";
+            writeTextPath(result.route, route_network, call_mode, out);
+            break;
+        }
+        case RESULT_DRIVING_WALKING: {
+            out << "DrivingRoute:";
+            if (result.status == ROUTE_NOT_FOUND) {
+                out << "none\n"
+                << "ParkingNode:none\n"
+                << "WalkingRoute:none\n"
+                << "TotalTime:none\n"
+                << "Message: " << result.message << "\n";
+                break;
+            }
+            writeTextPath(result.route, route_network, call_mode, out);
+            out << "Parking Node:";
+            writeLocation(result.parkingNode, route_network, call_mode, out);
+            out << "\nWalkingRoute:";
+            writeTextPath(result.walking, route_network, call_mode, out);
+            out << "TotalTime:" << result.totalTime << "\n";
+            break;
+        }
+        case RESULT_PARETO: {
+            out << "Options:";
+            if (result.options.empty()) {
+                out << "none\n"
+                << "Message: " << result.message << "\n";
+                break;
+            }
+            out << result.options.size() << "\n";
+            for (size_t i = 0; i < result.options.size(); i++) {
+                const RouteOption &option = result.options[i];
+                out << "Option:" << i + 1 << "\nDrivingRoute:";
+                writeTextPath(option.driving, route_network, call_mode, out);
+                out << "ParkingNode:";
+                writeLocation(option.parkingNode, route_network, call_mode, out);
+                out << "\nWalkingRoute:";
+                writeTextPath(option.walking, route_network, call_mode, out);
+                out << "TotalTime:" << option.totalTime << "\n";
+            }
+            break;
+        }
+        case RESULT_DISTANCE: {
+            out << "TravelMode:" << result.travelMode << "\nTravelTime:";
+            if (result.status == ROUTE_NOT_FOUND) out << "none\n";
+            else out << result.totalTime << "\n";
+            break;
+        }
+    }
+}
+
+std::string ResultFormatter::escapeJson(const std::string &text) {
+    std::ostringstream escaped;
+    for (unsigned char c : text) {
+        switch (c) {
+            case '"': escaped << "\\\""; break;
+            case '\\': escaped << "\\\\"; break;
+            case '\n': escaped << "\\n"; break;
+            case '\t': escaped << "\\t"; break;
+            default: {
+                if (c < 0x20) escaped << "\\u" << std::hex << std::setw(4) << std::setfill('0') << int(c) << std::dec;
+                else escaped << c;
+            }
+        }
+    }
+    return escaped.str();
+}
+
+void ResultFormatter::writeJsonPath(const PathResult &path, OutputSink &out) {
+    if (path.path.empty()) {
+        out << "null";
+        return;
+    }
+
+    std::ostringstream json;
+    json << std::setprecision(15) << "{\"path\":[";
+    for (size_t i = 0; i < path.path.size(); i++) {
+        if (i > 0) json << ",";
+        json << path.path[i];
+    }
+    json << "],\"weight\":" << path.weight << "}";
+    out << json.str();
+}
+
+void ResultFormatter::writeJsonLine(const RouteResult &result, OutputSink &out) {
+    static const char *statuses[] = {"ok", "not-found", "invalid"};
+
+    out << "{\"kind\":\"" << getKindName(result.kind) << "\",\"status\":\"" << statuses[result.status] << "\""
+    << ",\"source\":" << result.src << ",\"destination\":" << result.dest;
+
+    if (result.departureTime >= 0) out << ",\"departureTime\":\"" << InputHandler::formatClockTime(result.departureTime) << "\"";
+
+    if (result.status != ROUTE_INVALID) {
+        switch (result.kind) {
+            case RESULT_UNRESTRICTED_DRIVING: {
+                out << ",\"best\":";
+                writeJsonPath(result.route, out);
+                out << ",\"alternative\":";
+                writeJsonPath(result.alternative, out);
+                break;
+            }
+            case RESULT_RESTRICTED_DRIVING: {
+                out << ",\"restricted\":";
+                writeJsonPath(result.route, out);
+                break;
+            }
+            case RESULT_DRIVING_WALKING: {
+                std::ostringstream total;
+                total << std::setprecision(15) << result.totalTime;
+                out << ",\"driving\":";
+                writeJsonPath(result.route, out);
+                out << ",\"parking\":";
+                if (result.parkingNode < 0) out << "null";
+                else out << result.parkingNode;
+                out << ",\"walking\":";
+                writeJsonPath(result.walking, out);
+                out << ",\"totalTime\":" << (result.status == ROUTE_OK ? total.str() : "null")
+                << ",\"maxWalkTime\":" << result.maxWalkTime;
+                break;
+            }
+            case RESULT_PARETO: {
+                out << ",\"options\":[";
+                for (size_t i = 0; i < result.options.size(); i++) {
+                    const RouteOption &option = result.options[i];
+                    std::ostringstream total;
+                    total << std::setprecision(15) << option.totalTime;
+                    if (i > 0) out << ",";
+                    out << "{\"driving\":";
+                    writeJsonPath(option.driving, out);
+                    out << ",\"parking\":" << option.parkingNode << ",\"walking\":";
+                    writeJsonPath(option.walking, out);
+                    out << ",\"totalTime\":" << total.str() << "}";
+                }
+                out << "],\"maxWalkTime\":" << result.maxWalkTime;
+                break;
+            }
+            case RESULT_DISTANCE: {
+                std::ostringstream time;
+                time << std::setprecision(15) << result.totalTime;
+                out << ",\"travelMode\":\"" << escapeJson(result.travelMode) << "\""
+                << ",\"travelTime\":" << (result.status == ROUTE_OK ? time.str() : "null");
+                break;
+            }
+            case RESULT_REACHABILITY:
+            case RESULT_NEAREST_PARKING: {
+                std::ostringstream reached;
+                reached << std::setprecision(15) << "[";
+                for (size_t i = 0; i < result.reached.size(); i++) {
+                    if (i > 0) reached << ",";
+                    reached << "{\"id\":" << result.reached[i].id << ",\"time\":" << result.reached[i].time << "}";
+                }
+                reached << "]";
+                out << ",\"travelMode\":\"" << escapeJson(result.travelMode) << "\"";
+                if (result.kind == RESULT_REACHABILITY) out << ",\"maxTime\":" << result.maxTime << ",\"reachable\":" << reached.str();
+                else out << ",\"count\":" << result.count << ",\"parking\":" << reached.str();
+                break;
+            }
+        }
+    }
+
+    if (!result.message.empty()) out << ",\"message\":\"" << escapeJson(result.message) << "\"";
+    out << "}\n";
+}
+
+void ResultFormatter::writeBinary(const RouteResult &result, OutputSink &out) {
+    std::string record;
+    appendBinary<uint8_t>(record, result.kind);
+    appendBinary<uint8_t>(record, result.status);
+    appendBinary<int32_t>(record, result.src);
+    appendBinary<int32_t>(record, result.dest);
+
+    for (const PathResult *path : {&result.route, &result.alternative, &result.walking}) {
+        appendBinary<uint32_t>(record, path->path.size());
+        for (int id : path->path) appendBinary<int32_t>(record, id);
+        appendBinary<double>(record, path->weight);
+    }
+
+    appendBinary<int32_t>(record, result.parkingNode);
+    appendBinary<double>(record, result.totalTime);
+    appendBinary<int32_t>(record, result.departureTime);
+
+    if (result.kind == RESULT_REACHABILITY || result.kind == RESULT_NEAREST_PARKING) {
+        appendBinary<uint32_t>(record, result.reached.size());
+        for (const ReachedLocation &location : result.reached) {
+            appendBinary<int32_t>(record, location.id);
+            appendBinary<double>(record, location.time);
+        }
+    }
+
+    if (result.kind == RESULT_PARETO) {
+        appendBinary<uint32_t>(record, result.options.size());
+        for (const RouteOption &option : result.options) {
+            for (const PathResult *path : {&option.driving, &option.walking}) {
+                appendBinary<uint32_t>(record, path->path.size());
+                for (int id : path->path) appendBinary<int32_t>(record, id);
+                appendBinary<double>(record, path->weight);
+            }
+            appendBinary<int32_t>(record, option.parkingNode);
+            appendBinary<double>(record, option.totalTime);
+        }
+    }
+
+    std::string size;
+    appendBinary<uint32_t>(size, record.size());
+    out.write(size.data(), size.size());
+    out.write(record.data(), record.size());
+}
@@ -1,18 +1,13 @@
 #include "Route.h"
 
-Route::Route(Vertex<std::string> *orig, Vertex<std::string> *dest, double walking_time, double driving_time): Edge(orig, dest, walking_time, driving_time) {
-    orig_ = orig->getInfo();
-    dest_ = dest->getInfo();
-    walking_time_ = walking_time;
-    driving_time_ = driving_time;
-}
+Route::Route(Vertex<std::string> *orig, Vertex<std::string> *dest, double walking_time, double driving_time, unsigned id): Edge(orig, dest, walking_time, driving_time, id) {}
 
 std::string Route::get_orig() {
-    return orig_;
+    return orig->getInfo();
 }
 
 std::string Route::get_dest() {
-    return dest_;
+    return dest->getInfo();
 }
 
 
@@ -23,5 +18,3 @@ double Route::get_walking_time() {
 double Route::get_driving_time() {
     return driving_time_;
 }
-
-
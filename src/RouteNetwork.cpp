@@ -4,17 +4,23 @@
 #include <sstream>
 
 #include "InputHandler.h"
+#include "PathFinding.h"
+#include "QueryStats.h"
 #include "Route.h"
+#include "ThreadPool.h"
+
+std::atomic<uint64_t> RouteNetwork::next_serial_{1};
+thread_local uint64_t RouteNetwork::cached_network_ = 0;
+thread_local SearchContext *RouteNetwork::cached_context_ = nullptr;
 
 RouteNetwork::RouteNetwork() {
+    serial_ = next_serial_++;
     route_network_ = nullptr;
     locations_ = new std::unordered_map<std::string, Location*>();
 }
 
 RouteNetwork::~RouteNetwork() {
-    for (auto& pair : *locations_) {
-        delete pair.second;
-    }
+    // locations and routes live in the graph arena
     delete route_network_;
     delete locations_;
 
@@ -46,8 +52,8 @@ bool RouteNetwork::parseLocation(const std::string& location_file) {
 
         canPark = (std::stoi(park)  == 1);
 
-        auto* tempLocation = new Location(location,id,code,canPark);
-        this->addVertex(tempLocation);
+        auto* tempLocation = this->createVertex<Location>(location,id,code,canPark);
+        if (tempLocation == nullptr) continue;
 
         this->locations_->insert(std::make_pair(code,tempLocation));
 
@@ -66,7 +72,7 @@ bool RouteNetwork::parseRoute(const std::string& route_file) {
         return false;
     }
 
-    std::string orig_location, dest_location, walking_time, driving_time;
+    std::string orig_location, dest_location, walking_time, driving_time, profile;
     std::istringstream iss(line);
     char sep = ',';
     double w_time, d_time;
@@ -77,7 +83,10 @@ bool RouteNetwork::parseRoute(const std::string& route_file) {
         getline(iss,dest_location,sep);
         getline(iss,driving_time,sep);
         getline(iss,walking_time,sep);
+        profile.clear();
+        getline(iss,profile,sep);
         InputHandler::trimString(walking_time);
+        InputHandler::trimString(profile);
 
         if (driving_time == "X") {
             d_time = INT_MAX;
@@ -87,7 +96,22 @@ bool RouteNetwork::parseRoute(const std::string& route_file) {
         }
         w_time = std::stod(walking_time);
 
-        addBidirectionalEdge(orig_location,dest_location,w_time,d_time);
+        uint16_t p = NO_PROFILE;
+        if (!profile.empty()) {
+            try {p = profiles_.find(std::stoi(profile));}
+            catch (const std::logic_error&) {}
+            if (p == NO_PROFILE) {
+                std::cout << "Route " << orig_location << "-" << dest_location << ": unknown profile " << profile << std::endl;
+            }
+            else if (d_time >= INT_MAX) p = NO_PROFILE; // never driven
+            else if (!profiles_.isFifo(p, d_time)) {
+                std::cout << "Route " << orig_location << "-" << dest_location << ": profile " << profile
+                << " lets later departures arrive earlier, using the constant driving time" << std::endl;
+                p = NO_PROFILE;
+            }
+        }
+
+        if (addBidirectionalEdge(orig_location,dest_location,w_time,d_time)) segment_profiles_.push_back(p);
     }
 
     routes.close();
@@ -96,6 +120,219 @@ bool RouteNetwork::parseRoute(const std::string& route_file) {
 
 }
 
+void RouteNetwork::buildRoutingGraph() {
+    routing_graph_.clear();
+    nodes_.clear();
+    for (auto v : vertexSet) {
+        auto* l = static_cast<Location*>(v);
+        l->setIndex(nodes_.size());
+        nodes_.push_back(l);
+    }
+
+    for (auto l : nodes_) {
+        routing_graph_.addNode();
+        for (auto e : l->getAdj()) {
+            routing_graph_.addArc(static_cast<Location*>(e->getDest(l))->getIndex(), e->getId());
+            routing_graph_.setSegment(e->getId(), e->getWalkingTime(), e->getDrivingTime());
+            routing_graph_.setProfile(e->getId(), segment_profiles_[e->getId()]);
+        }
+    }
+
+    if (node_order_ != ORDER_INPUT) {
+        std::vector<uint32_t> order = NodeOrdering::compute(routing_graph_, node_order_);
+        routing_graph_ = routing_graph_.permuted(order);
+        std::vector<Location*> input_nodes;
+        input_nodes.swap(nodes_);
+        for (uint32_t i = 0; i < order.size(); i++) {
+            input_nodes[order[i]]->setIndex(i);
+            nodes_.push_back(input_nodes[order[i]]);
+        }
+    }
+
+    parking_.assign(nodes_.size(), 0);
+    for (auto l : nodes_) parking_[l->getIndex()] = l->getCanPark();
+
+    node_by_id_.clear();
+    node_by_id_.reserve(nodes_.size());
+    for (auto v : vertexSet) {
+        auto* l = static_cast<Location*>(v);
+        try {node_by_id_.emplace(std::stoi(l->getId()), l->getIndex());}
+        catch (const std::logic_error&) {} // not a numeric ID, the location can only be found by code or name
+    }
+
+    PathFinding::labelComponents(routing_graph_, WALKING_MODE, components_[WALKING_MODE]);
+    driving_stale_ = true;
+    if (use_hierarchy_) hierarchy_.build(routing_graph_);
+    hierarchy_stale_ = use_hierarchy_;
+    hub_labels_.clear();
+    labels_stale_ = use_hub_labels_ && (label_file_.empty() || !hub_labels_.load(label_file_, routing_graph_));
+    delta_stepping_.resetDelta();
+    refreshDerivedData();
+
+    // the trees and blocked flags of every thread refer to the previous graph
+    std::lock_guard<std::mutex> lock(contexts_mutex_);
+    for (auto &[thread, context] : contexts_) resetSearchContext(*context);
+}
+
+void RouteNetwork::refreshDerivedData() {
+    // the driving connectivity and the hierarchy only read the routing graph, so they are refreshed at the same time
+    TaskGroup group(ThreadPool::shared());
+    if (driving_stale_) {
+        group.run([this] {
+            PathFinding::labelComponents(routing_graph_, DRIVING_MODE, components_[DRIVING_MODE]);
+            driving_separation_.build(routing_graph_, DRIVING_MODE);
+        });
+        driving_stale_ = false;
+    }
+    if (hierarchy_stale_) {
+        hierarchy_.customize(routing_graph_);
+        hierarchy_stale_ = false;
+    }
+    group.wait();
+
+    if (labels_stale_) {
+        // the labels follow the order and weights of a customized hierarchy, the one of the network if it has one
+        CustomizableHierarchy hierarchy;
+        if (!use_hierarchy_) {
+            hierarchy.build(routing_graph_);
+            hierarchy.customize(routing_graph_);
+        }
+        hub_labels_.build(routing_graph_, use_hierarchy_ ? hierarchy_ : hierarchy);
+        labels_stale_ = false;
+        if (!label_file_.empty() && !hub_labels_.save(label_file_)) {
+            std::cout << "Could not save the hub labels to " << label_file_ << "." << std::endl;
+        }
+    }
+}
+
+bool RouteNetwork::setSegmentTimes(Location* l1, Location* l2, double walking_time, double driving_time) {
+    bool found = false;
+    for (auto e : l1->getAdj()) {
+        if (e->getDest(l1) != l2) continue;
+        e->setWalkingTime(walking_time);
+        e->setDrivingTime(driving_time);
+    }
+
+    uint32_t u = l1->getIndex(), v = l2->getIndex();
+    for (uint32_t a = routing_graph_.firstArc(u); a < routing_graph_.endArc(u); a++) {
+        if (routing_graph_.getArc(a).target != v) continue;
+        found = true;
+        hierarchy_stale_ = use_hierarchy_;
+        labels_stale_ = use_hub_labels_;
+        delta_stepping_.resetDelta();
+        {
+            std::lock_guard<std::mutex> lock(contexts_mutex_);
+            for (auto &[thread, context] : contexts_) context->search.source = context->base.source = NO_NODE;
+        }
+        if ((routing_graph_.getWeight(a, DRIVING_MODE) >= INT_MAX) != (driving_time >= INT_MAX)) driving_stale_ = true;
+        routing_graph_.setSegment(routing_graph_.getArc(a).segment, walking_time, driving_time);
+        uint16_t profile = routing_graph_.getProfile(a);
+        if (profile != NO_PROFILE && (driving_time >= INT_MAX || !profiles_.isFifo(profile, driving_time))) {
+            routing_graph_.setProfile(routing_graph_.getArc(a).segment, NO_PROFILE);
+        }
+    }
+    return found;
+}
+
+bool RouteNetwork::updateSegment(int id1, int id2, double walking_time, double driving_time) {
+    Location* l1 = getLocationById(id1);
+    Location* l2 = getLocationById(id2);
+    if (l1 == nullptr || l2 == nullptr) return false;
+    bool found = setSegmentTimes(l1, l2, walking_time, driving_time);
+    refreshDerivedData();
+    return found;
+}
+
+int RouteNetwork::applyUpdates(const std::string& update_file) {
+    std::ifstream updates(update_file);
+    std::string line;
+
+    if (!std::getline(updates,line)) {
+        return -1;
+    }
+
+    std::string orig_location, dest_location, walking_time, driving_time;
+    std::istringstream iss(line);
+    char sep = ',';
+    double w_time, d_time;
+    int applied = 0;
+    while (std::getline(updates,line)) {
+        iss.clear();
+        iss.str(line);
+        getline(iss,orig_location,sep);
+        getline(iss,dest_location,sep);
+        getline(iss,driving_time,sep);
+        getline(iss,walking_time,sep);
+        InputHandler::trimString(driving_time);
+        InputHandler::trimString(walking_time);
+
+        Location* l1 = getLocationByCode(orig_location);
+        Location* l2 = getLocationByCode(dest_location);
+        if (l1 == nullptr || l2 == nullptr) continue;
+
+        try {
+            d_time = driving_time == "X" ? INT_MAX : std::stod(driving_time);
+            w_time = std::stod(walking_time);
+        }
+        catch (const std::logic_error&) {continue;} // a malformed row must not stop the updates after it
+
+        if (setSegmentTimes(l1, l2, w_time, d_time)) applied++;
+    }
+
+    updates.close();
+    refreshDerivedData();
+    return applied;
+}
+
+void RouteNetwork::setNodeOrder(int order) {
+    node_order_ = order;
+}
+
+void RouteNetwork::setProfileFile(const std::string& profile_file) {
+    profile_file_ = profile_file;
+}
+
+void RouteNetwork::setDepartureTime(double minutes) {
+    getSearchContext().departureTime = minutes;
+}
+
+void RouteNetwork::setHierarchy(bool enabled) {
+    use_hierarchy_ = enabled;
+}
+
+CustomizableHierarchy& RouteNetwork::getHierarchy() {
+    return hierarchy_;
+}
+
+void RouteNetwork::setHubLabels(bool enabled, const std::string &label_file) {
+    use_hub_labels_ = enabled;
+    label_file_ = label_file;
+}
+
+double RouteNetwork::getTravelTime(int src, int dest, bool mode) {
+    Location *org = getLocationById(src);
+    Location *target = getLocationById(dest);
+    if (org == nullptr || target == nullptr) return -1;
+    if (!sameComponent(org->getIndex(), target->getIndex(), mode)) return INT_MAX;
+
+    if (use_hub_labels_ && !hasBlocked() && PathFinding::searchDeparture(this, mode) < 0) {
+        PhaseTimer timer(PHASE_SEARCH);
+        QueryCounters *stats = QueryStats::current();
+        if (stats) stats->searches++;
+        return hub_labels_.query(org->getIndex(), target->getIndex(), mode);
+    }
+    if (!PathFinding::reuseTree(this, src, mode)) PathFinding::dijkstra(this, src, mode);
+    return PathFinding::getDist(this, target);
+}
+
+void RouteNetwork::setSearchThreads(int threads, double delta) {
+    delta_stepping_.configure(threads, delta);
+}
+
+DeltaStepping& RouteNetwork::getDeltaStepping() {
+    return delta_stepping_;
+}
+
 bool RouteNetwork::parseData(const std::string &location_data, const std::string &route_data) {
 
     if (!parseLocation(location_data)) {
@@ -103,7 +340,15 @@ bool RouteNetwork::parseData(const std::string &location_data, const std::string
         return false;
     }
 
-    if (!parseRoute(route_data)) {
+    if (!profile_file_.empty() && !profiles_.parse(profile_file_)) {
+        std::cout << "Profile file does not exist" << std::endl;
+        return false;
+    }
+
+    bool routes_parsed = parseRoute(route_data);
+    buildRoutingGraph();
+
+    if (!routes_parsed) {
         std::cout << "Route file does not exist" << std::endl;
         return false;
     }
@@ -119,10 +364,9 @@ int RouteNetwork::getNumberOfLocations() {
 }
 
 Location* RouteNetwork::getLocationById(int id) {
-    for (auto loc : *locations_) {
-        if (std::stoi(loc.second->getId()) == id) return loc.second;
-    }
-    return nullptr;
+    auto it = node_by_id_.find(id);
+    if (it == node_by_id_.end()) return nullptr;
+    return nodes_[it->second];
 }
 
 Location* RouteNetwork::getLocationByCode(const std::string& code) {
@@ -147,46 +391,114 @@ Location* RouteNetwork::getLocationByName(const std::string& name) {
 }
 
 
-std::vector<Vertex<std::string>*> RouteNetwork::getLocationSet() {
+Span<Vertex<std::string>*> RouteNetwork::getLocationSet() const {
     return this->getVertexSet();
 }
 
-void RouteNetwork::blockNode(int id) {
-    Location* l = getLocationById(id);
-    blockedNodes.insert(l);
+const RoutingGraph& RouteNetwork::getRoutingGraph() const {
+    return routing_graph_;
 }
 
-void RouteNetwork::blockEdge(int id1, int id2) {
-    Vertex<std::string>* l1 = getLocationById(id1);
-    Vertex<std::string>* l2 = getLocationById(id2);
+SearchContext& RouteNetwork::findSearchContext() {
+    std::lock_guard<std::mutex> lock(contexts_mutex_);
+    std::unique_ptr<SearchContext> &context = contexts_[std::this_thread::get_id()];
+    if (!context) {
+        context = std::make_unique<SearchContext>();
+        resetSearchContext(*context);
+    }
+    cached_network_ = serial_;
+    cached_context_ = context.get();
+    return *context;
+}
 
-    for (auto e : l1->getAdj()) {
-        auto w = e->getDest();
-        if (l2 == w) {
-            blockedEdges.insert(e);
-        }
+void RouteNetwork::resetSearchContext(SearchContext &context) {
+    context.search.source = NO_NODE;
+    context.base.source = NO_NODE;
+    context.search.blockedNodes = context.search.blockedSegments = 0;
+    context.blockedNodes.assign(routing_graph_.getNumNodes(), 0);
+    context.blockedSegments.assign(routing_graph_.getNumSegments(), 0);
+    context.blockedNodeList.clear();
+    context.blockedSegmentList.clear();
+}
+
+Location* RouteNetwork::getLocationByIndex(uint32_t index) {
+    return nodes_[index];
+}
+
+std::vector<std::pair<Location*, double>> RouteNetwork::findNearestParking(int id, int k, bool mode) {
+    std::vector<std::pair<Location*, double>> parking;
+    Location* l = getLocationById(id);
+    if (l == nullptr || k <= 0) return parking;
+
+    std::vector<std::pair<uint32_t, double>> reached;
+    // the budget only excludes segments that cannot be driven, which weigh INT_MAX
+    PathFinding::boundedSearch(this, {{l->getIndex(), 0}}, mode, INT_MAX - 1, reached, &parking_, k);
+    for (auto [v, time] : reached) {
+        if (parking_[v]) parking.emplace_back(nodes_[v], time);
     }
+    return parking;
+}
 
-    for (auto e : l2->getAdj()) {
-        auto w = e->getDest();
-        if (l1 == w) {
-            blockedEdges.insert(e);
-        }
+bool RouteNetwork::areConnected(int id1, int id2, bool mode) {
+    Location* l1 = getLocationById(id1);
+    Location* l2 = getLocationById(id2);
+    if (l1 == nullptr || l2 == nullptr) return false;
+    return sameComponent(l1->getIndex(), l2->getIndex(), mode);
+}
+
+bool RouteNetwork::avoidSeparates(int src, int dest, const std::vector<int> &avoid_nodes, const std::vector<std::pair<int, int>> &avoid_segments) {
+    Location* l_src = getLocationById(src);
+    Location* l_dest = getLocationById(dest);
+    if (l_src == nullptr || l_dest == nullptr) return false;
+    uint32_t s = l_src->getIndex(), t = l_dest->getIndex();
 
+    for (int id : avoid_nodes) {
+        Location* l = getLocationById(id);
+        if (l == nullptr) continue;
+        if (l == l_src || driving_separation_.nodeSeparates(l->getIndex(), s, t)) return true;
     }
+    for (auto [id1, id2] : avoid_segments) {
+        Location* l1 = getLocationById(id1);
+        Location* l2 = getLocationById(id2);
+        if (l1 == nullptr || l2 == nullptr) continue;
+        if (driving_separation_.segmentSeparates(l1->getIndex(), l2->getIndex(), s, t)) return true;
+    }
+    return false;
 }
 
-bool RouteNetwork::isNodeBlocked(Vertex<std::string>* v) {
-    return blockedNodes.find(v) != blockedNodes.end();
+void RouteNetwork::blockNode(int id) {
+    Location* l = getLocationById(id);
+    SearchContext &context = getSearchContext();
+    if (l == nullptr || context.blockedNodes[l->getIndex()]) return;
+    context.blockedNodes[l->getIndex()] = 1;
+    context.blockedNodeList.push_back(l->getIndex());
 }
 
-bool RouteNetwork::isEdgeBlocked(Edge<std::string>* e) {
-    return blockedEdges.find(e) != blockedEdges.end();
+void RouteNetwork::blockEdge(int id1, int id2) {
+    Location* l1 = getLocationById(id1);
+    Location* l2 = getLocationById(id2);
+    if (l1 == nullptr || l2 == nullptr) return;
+
+    SearchContext &context = getSearchContext();
+    uint32_t u = l1->getIndex(), v = l2->getIndex();
+    for (uint32_t a = routing_graph_.firstArc(u); a < routing_graph_.endArc(u); a++) {
+        uint32_t s = routing_graph_.getArc(a).segment;
+        if (routing_graph_.getArc(a).target == v && !context.blockedSegments[s]) {
+            context.blockedSegments[s] = 1; // blocks both directions, they share the segment
+            context.blockedSegmentList.push_back(a);
+        }
+    }
 }
 
 void RouteNetwork::clearBlocked() {
-    blockedNodes.clear();
-    blockedEdges.clear();
+    SearchContext &context = getSearchContext();
+    SearchState &state = context.search;
+    if (state.blockedNodes > 0 || state.blockedSegments > 0) state.source = NO_NODE;
+    state.blockedNodes = state.blockedSegments = 0;
+    for (uint32_t v : context.blockedNodeList) context.blockedNodes[v] = 0;
+    for (uint32_t a : context.blockedSegmentList) context.blockedSegments[routing_graph_.getArc(a).segment] = 0;
+    context.blockedNodeList.clear();
+    context.blockedSegmentList.clear();
 }
 
 void RouteNetwork::showLocationInfoById(std::string const&  id) {
@@ -298,7 +610,7 @@ void RouteNetwork::restrictedRouteById(int src, int dest, RouteNetwork& route_ne
         bool is_dest = false;
         Location* temp_loc = getLocationById(route_src);
         for (auto edge : temp_loc->getAdj()) {
-            if (static_cast<Location*> (edge->getDest())->getId() == std::to_string(route_dest)) {
+            if (static_cast<Location*> (edge->getDest(temp_loc))->getId() == std::to_string(route_dest)) {
                 is_dest = true;
             }
         }
@@ -362,7 +674,7 @@ void RouteNetwork::restrictedRouteByCode(const std::string &src, const std::stri
         }
         bool is_dest = false;
         for (auto edge : l_src->getAdj()) {
-            if (InputHandler::toLowerString(static_cast<Location*> (edge->getDest())->getCode()) == InputHandler::toLowerString(route_dest)) {
+            if (InputHandler::toLowerString(static_cast<Location*> (edge->getDest(l_src))->getCode()) == InputHandler::toLowerString(route_dest)) {
                 is_dest = true;
             }
         }
@@ -419,7 +731,7 @@ void RouteNetwork::restrictedRouteByName(const std::string &src, const std::stri
         }
         bool is_dest = false;
         for (auto edge : l_src->getAdj()) {
-            if (InputHandler::toLowerString(static_cast<Location*> (edge->getDest())->getName()) == InputHandler::toLowerString(route_dest)) {
+            if (InputHandler::toLowerString(static_cast<Location*> (edge->getDest(l_src))->getName()) == InputHandler::toLowerString(route_dest)) {
                 is_dest = true;
             }
         }
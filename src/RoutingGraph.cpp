@@ -0,0 +1,61 @@
+#include "RoutingGraph.h"
+
+#include <algorithm>
+
+void RoutingGraph::clear() {
+    first_.assign(1, 0);
+    arcs_.clear();
+    segments_.clear();
+    profiles_.clear();
+}
+
+uint32_t RoutingGraph::addNode() {
+    first_.push_back(arcs_.size());
+    return first_.size() - 2;
+}
+
+void RoutingGraph::addArc(uint32_t target, uint32_t segment) {
+    arcs_.push_back({target, segment});
+    first_.back()++;
+}
+
+RoutingGraph RoutingGraph::permuted(const std::vector<uint32_t> &order) const {
+    std::vector<uint32_t> rank(order.size());
+    for (uint32_t i = 0; i < order.size(); i++) rank[order[i]] = i;
+
+    RoutingGraph graph;
+    graph.arcs_.reserve(arcs_.size());
+    graph.segments_.reserve(segments_.size());
+    std::vector<uint32_t> segment(segments_.size(), NO_NODE);
+    for (uint32_t u : order) {
+        graph.addNode();
+        for (uint32_t a = firstArc(u); a < endArc(u); a++) {
+            uint32_t s = arcs_[a].segment;
+            if (segment[s] == NO_NODE) {
+                segment[s] = graph.segments_.size();
+                graph.segments_.push_back(segments_[s]);
+                if (!profiles_.empty()) graph.profiles_.push_back(profiles_[s]);
+            }
+            graph.addArc(rank[arcs_[a].target], segment[s]);
+        }
+    }
+    return graph;
+}
+
+uint32_t RoutingGraph::arcSource(uint32_t a) const {
+    return std::upper_bound(first_.begin(), first_.end(), a) - first_.begin() - 1;
+}
+
+void RoutingGraph::setSegment(uint32_t segment, double walking, double driving) {
+    if (segment >= segments_.size()) {
+        segments_.resize(segment + 1);
+        if (!profiles_.empty()) profiles_.resize(segment + 1, NO_PROFILE);
+    }
+    segments_[segment] = {float(walking), float(driving)};
+}
+
+void RoutingGraph::setProfile(uint32_t segment, uint16_t profile) {
+    if (profiles_.empty() && profile == NO_PROFILE) return; // graphs without profiles store none
+    profiles_.resize(segments_.size(), NO_PROFILE);
+    profiles_[segment] = profile;
+}
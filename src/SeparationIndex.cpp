@@ -0,0 +1,80 @@
+#include "SeparationIndex.h"
+
+#include <algorithm>
+#include <climits>
+
+void SeparationIndex::build(const RoutingGraph &graph, bool isDriving) {
+    uint32_t n = graph.getNumNodes();
+    disc_.assign(n, NO_NODE);
+    finish_.assign(n, 0);
+    low_.assign(n, 0);
+    parent_.assign(n, NO_NODE);
+
+    std::vector<uint32_t> order; // nodes by discovery time
+    order.reserve(n);
+    std::vector<std::pair<uint32_t, uint32_t>> stack; // node and its next arc, so deep networks do not overflow the call stack
+
+    for (uint32_t root = 0; root < n; root++) {
+        if (disc_[root] != NO_NODE) continue;
+        disc_[root] = low_[root] = order.size();
+        order.push_back(root);
+        stack.emplace_back(root, graph.firstArc(root));
+
+        while (!stack.empty()) {
+            uint32_t u = stack.back().first;
+            uint32_t &a = stack.back().second;
+            if (a == graph.endArc(u)) {
+                finish_[u] = order.size();
+                stack.pop_back();
+                if (parent_[u] != NO_NODE) low_[parent_[u]] = std::min(low_[parent_[u]], low_[u]);
+                continue;
+            }
+            uint32_t arc = a++;
+            uint32_t w = graph.getArc(arc).target;
+            // every segment to the parent is skipped, so parallel segments count as one when looking for bridges
+            if (w == parent_[u] || graph.getWeight(arc, isDriving) >= INT_MAX) continue;
+            if (disc_[w] != NO_NODE) {
+                low_[u] = std::min(low_[u], disc_[w]);
+                continue;
+            }
+            parent_[w] = u;
+            disc_[w] = low_[w] = order.size();
+            order.push_back(w);
+            stack.emplace_back(w, graph.firstArc(w));
+        }
+    }
+
+    first_child_.assign(n + 1, 0);
+    for (uint32_t u = 0; u < n; u++) {
+        if (parent_[u] != NO_NODE) first_child_[parent_[u] + 1]++;
+    }
+    for (uint32_t u = 0; u < n; u++) first_child_[u + 1] += first_child_[u];
+    children_.assign(first_child_[n], 0);
+    std::vector<uint32_t> next(first_child_.begin(), first_child_.end() - 1);
+    for (uint32_t u : order) {
+        if (parent_[u] != NO_NODE) children_[next[parent_[u]]++] = u;
+    }
+}
+
+uint32_t SeparationIndex::pieceWithout(uint32_t x, uint32_t u) const {
+    if (!inSubtree(x, u)) return NO_NODE;
+    auto begin = children_.begin() + first_child_[x];
+    auto end = children_.begin() + first_child_[x + 1];
+    auto it = std::upper_bound(begin, end, disc_[u], [this](uint32_t d, uint32_t c) { return d < disc_[c]; });
+    uint32_t c = *(it - 1);
+    return low_[c] >= disc_[x] ? c : NO_NODE;
+}
+
+bool SeparationIndex::nodeSeparates(uint32_t x, uint32_t s, uint32_t t) const {
+    if (x == s || x == t) return false;
+    return pieceWithout(x, s) != pieceWithout(x, t);
+}
+
+bool SeparationIndex::segmentSeparates(uint32_t u, uint32_t v, uint32_t s, uint32_t t) const {
+    uint32_t c;
+    if (parent_[v] == u) c = v;
+    else if (parent_[u] == v) c = u;
+    else return false;
+    if (low_[c] <= disc_[parent_[c]]) return false;
+    return inSubtree(c, s) != inSubtree(c, t);
+}
@@ -0,0 +1,230 @@
+#include "SimdKernels.h"
+
+#include <algorithm>
+#include <limits>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SIMD_X86
+#include <immintrin.h>
+#endif
+
+static const double NO_SUM = std::numeric_limits<double>::infinity();
+
+int SimdKernels::level_ = SIMD_SCALAR;
+
+/**
+ * @brief Merges two labels one hub at a time, from the given positions on.
+ */
+static double mergeScalar(const uint32_t *hubs_a, const double *dists_a, size_t i, size_t size_a,
+                          const uint32_t *hubs_b, const double *dists_b, size_t j, size_t size_b, double best) {
+    while (i < size_a && j < size_b) {
+        if (hubs_a[i] < hubs_b[j]) i++;
+        else if (hubs_a[i] > hubs_b[j]) j++;
+        else {
+            best = std::min(best, dists_a[i] + dists_b[j]);
+            i++;
+            j++;
+        }
+    }
+    return best;
+}
+
+/**
+ * @brief Compares arcs one at a time, from the given arc on, adding them to a relaxation mask.
+ */
+static uint64_t relaxScalar(const RoutingArc *arcs, uint32_t i, uint32_t count, const SegmentWeights *segments, bool isDriving,
+                            const double *dist, double base, uint64_t mask) {
+    for (; i < count; i++) {
+        const SegmentWeights &s = segments[arcs[i].segment];
+        double d = base + (isDriving ? s.driving : s.walking);
+        if (dist[arcs[i].target] > d) mask |= uint64_t(1) << i;
+    }
+    return mask;
+}
+
+#ifdef SIMD_X86
+
+/**
+ * @brief Merges two labels four hubs at a time.
+ *
+ * Hubs are compared as 64-bit lanes, so each match mask selects a distance directly: every hub of the block of b
+ * is broadcast against the block of a, and the distance of the matching hub, if any, is or-ed into the lanes of a.
+ */
+__attribute__((target("sse4.1")))
+static double intersectSse4(const uint32_t *hubs_a, const double *dists_a, size_t size_a,
+                            const uint32_t *hubs_b, const double *dists_b, size_t size_b) {
+    const __m128d none = _mm_set1_pd(NO_SUM);
+    __m128d best_low = none, best_high = none;
+    size_t i = 0, j = 0;
+    while (i + 4 <= size_a && j + 4 <= size_b) {
+        __m128i low = _mm_cvtepu32_epi64(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(hubs_a + i)));
+        __m128i high = _mm_cvtepu32_epi64(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(hubs_a + i + 2)));
+        __m128i found_low = _mm_setzero_si128(), found_high = _mm_setzero_si128();
+        __m128d other_low = _mm_setzero_pd(), other_high = _mm_setzero_pd();
+        for (int k = 0; k < 4; k++) {
+            __m128i hub = _mm_set1_epi64x(hubs_b[j + k]);
+            __m128d dist = _mm_load1_pd(dists_b + j + k);
+            __m128i eq_low = _mm_cmpeq_epi64(low, hub), eq_high = _mm_cmpeq_epi64(high, hub);
+            found_low = _mm_or_si128(found_low, eq_low);
+            found_high = _mm_or_si128(found_high, eq_high);
+            other_low = _mm_or_pd(other_low, _mm_and_pd(_mm_castsi128_pd(eq_low), dist));
+            other_high = _mm_or_pd(other_high, _mm_and_pd(_mm_castsi128_pd(eq_high), dist));
+        }
+        __m128d sum_low = _mm_add_pd(_mm_loadu_pd(dists_a + i), other_low);
+        __m128d sum_high = _mm_add_pd(_mm_loadu_pd(dists_a + i + 2), other_high);
+        best_low = _mm_min_pd(best_low, _mm_blendv_pd(none, sum_low, _mm_castsi128_pd(found_low)));
+        best_high = _mm_min_pd(best_high, _mm_blendv_pd(none, sum_high, _mm_castsi128_pd(found_high)));
+
+        uint32_t last_a = hubs_a[i + 3], last_b = hubs_b[j + 3];
+        i += 4 & -size_t(last_a <= last_b);
+        j += 4 & -size_t(last_b <= last_a);
+    }
+    __m128d best = _mm_min_pd(best_low, best_high);
+    best = _mm_min_sd(best, _mm_unpackhi_pd(best, best));
+    return mergeScalar(hubs_a, dists_a, i, size_a, hubs_b, dists_b, j, size_b, _mm_cvtsd_f64(best));
+}
+
+/**
+ * @brief Merges two labels eight hubs at a time.
+ *
+ * The block of b is compared in its eight rotations against the block of a. Besides the matches, the comparisons
+ * count the hubs of b below each hub of a, which is the position of its match, so the matching distances are
+ * gathered without a branch.
+ */
+__attribute__((target("avx2")))
+static double intersectAvx2(const uint32_t *hubs_a, const double *dists_a, size_t size_a,
+                            const uint32_t *hubs_b, const double *dists_b, size_t size_b) {
+    static const int32_t rotations[7][8] = {{1, 2, 3, 4, 5, 6, 7, 0}, {2, 3, 4, 5, 6, 7, 0, 1}, {3, 4, 5, 6, 7, 0, 1, 2},
+                                            {4, 5, 6, 7, 0, 1, 2, 3}, {5, 6, 7, 0, 1, 2, 3, 4}, {6, 7, 0, 1, 2, 3, 4, 5},
+                                            {7, 0, 1, 2, 3, 4, 5, 6}};
+    const __m256d none = _mm256_set1_pd(NO_SUM);
+    __m256d best_low = none, best_high = none;
+    size_t i = 0, j = 0;
+    while (i + 8 <= size_a && j + 8 <= size_b) {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(hubs_a + i));
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(hubs_b + j));
+        // hubs are below 2^31, so the signed comparison orders them
+        __m256i found = _mm256_cmpeq_epi32(a, b);
+        __m256i below = _mm256_cmpgt_epi32(a, b);
+        for (int r = 0; r < 7; r++) {
+            __m256i rotated = _mm256_permutevar8x32_epi32(b, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rotations[r])));
+            found = _mm256_or_si256(found, _mm256_cmpeq_epi32(a, rotated));
+            below = _mm256_add_epi32(below, _mm256_cmpgt_epi32(a, rotated));
+        }
+        __m256i position = _mm256_sub_epi32(_mm256_setzero_si256(), below);
+        __m256d found_low = _mm256_castsi256_pd(_mm256_cvtepi32_epi64(_mm256_castsi256_si128(found)));
+        __m256d found_high = _mm256_castsi256_pd(_mm256_cvtepi32_epi64(_mm256_extracti128_si256(found, 1)));
+        __m256d other_low = _mm256_mask_i32gather_pd(none, dists_b + j, _mm256_castsi256_si128(position), found_low, sizeof(double));
+        __m256d other_high = _mm256_mask_i32gather_pd(none, dists_b + j, _mm256_extracti128_si256(position, 1), found_high, sizeof(double));
+        best_low = _mm256_min_pd(best_low, _mm256_add_pd(_mm256_loadu_pd(dists_a + i), other_low));
+        best_high = _mm256_min_pd(best_high, _mm256_add_pd(_mm256_loadu_pd(dists_a + i + 4), other_high));
+
+        uint32_t last_a = hubs_a[i + 7], last_b = hubs_b[j + 7];
+        i += 8 & -size_t(last_a <= last_b);
+        j += 8 & -size_t(last_b <= last_a);
+    }
+    __m256d best4 = _mm256_min_pd(best_low, best_high);
+    __m128d best = _mm_min_pd(_mm256_castpd256_pd128(best4), _mm256_extractf128_pd(best4, 1));
+    best = _mm_min_sd(best, _mm_unpackhi_pd(best, best));
+    return mergeScalar(hubs_a, dists_a, i, size_a, hubs_b, dists_b, j, size_b, _mm_cvtsd_f64(best));
+}
+
+/**
+ * @brief Compares arcs two at a time.
+ */
+__attribute__((target("sse4.1")))
+static uint64_t relaxSse4(const RoutingArc *arcs, uint32_t count, const SegmentWeights *segments, bool isDriving,
+                          const double *dist, double base) {
+    // SSE has no gathers, so only the additions and comparisons are paired
+    const __m128d from = _mm_set1_pd(base);
+    uint64_t mask = 0;
+    uint32_t i = 0;
+    for (; i + 2 <= count; i += 2) {
+        const SegmentWeights &s0 = segments[arcs[i].segment], &s1 = segments[arcs[i + 1].segment];
+        __m128d w = _mm_setr_pd(isDriving ? s0.driving : s0.walking, isDriving ? s1.driving : s1.walking);
+        __m128d d = _mm_setr_pd(dist[arcs[i].target], dist[arcs[i + 1].target]);
+        __m128d better = _mm_cmpgt_pd(d, _mm_add_pd(from, w));
+        mask |= uint64_t(_mm_movemask_pd(better)) << i;
+    }
+    return relaxScalar(arcs, i, count, segments, isDriving, dist, base, mask);
+}
+
+/**
+ * @brief Compares arcs four at a time, gathering their weights and the distances of their targets.
+ */
+__attribute__((target("avx2")))
+static uint64_t relaxAvx2(const RoutingArc *arcs, uint32_t count, const SegmentWeights *segments, bool isDriving,
+                          const double *dist, double base) {
+    const __m256d from = _mm256_set1_pd(base);
+    const __m256i split = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+    const __m128i mode = _mm_set1_epi32(isDriving);
+    const float *weights = reinterpret_cast<const float*>(segments);
+    const __m128 all_lanes_ps = _mm_castsi128_ps(_mm_set1_epi32(-1));
+    const __m256d all_lanes_pd = _mm256_castsi256_pd(_mm256_set1_epi32(-1));
+    uint64_t mask = 0;
+    uint32_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        // four (target, segment) pairs, split into the four targets and the four segments
+        __m256i pairs = _mm256_permutevar8x32_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(arcs + i)), split);
+        __m128i targets = _mm256_castsi256_si128(pairs);
+        __m128i slots = _mm_add_epi32(_mm_slli_epi32(_mm256_extracti128_si256(pairs, 1), 1), mode);
+        // the masked gathers, with every lane enabled, avoid the undefined source register of the plain ones
+        __m256d w = _mm256_cvtps_pd(_mm_mask_i32gather_ps(_mm_setzero_ps(), weights, slots, all_lanes_ps, sizeof(float)));
+        __m256d d = _mm256_mask_i32gather_pd(_mm256_setzero_pd(), dist, targets, all_lanes_pd, sizeof(double));
+        __m256d better = _mm256_cmp_pd(d, _mm256_add_pd(from, w), _CMP_GT_OQ);
+        mask |= uint64_t(_mm256_movemask_pd(better)) << i;
+    }
+    return relaxScalar(arcs, i, count, segments, isDriving, dist, base, mask);
+}
+
+#endif
+
+int SimdKernels::detectLevel() {
+#ifdef SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return SIMD_AVX2;
+    if (__builtin_cpu_supports("sse4.1")) return SIMD_SSE4;
+#endif
+    return SIMD_SCALAR;
+}
+
+bool SimdKernels::setLevel(int level) {
+    if (level < SIMD_SCALAR || level > detectLevel()) return false;
+    level_ = level;
+    return true;
+}
+
+bool SimdKernels::parseLevel(const std::string &name, int &level) {
+    if (name == "auto") level = detectLevel();
+    else if (name == "scalar") level = SIMD_SCALAR;
+    else if (name == "sse4") level = SIMD_SSE4;
+    else if (name == "avx2") level = SIMD_AVX2;
+    else return false;
+    return true;
+}
+
+const char *SimdKernels::getLevelName(int level) {
+    switch (level) {
+        case SIMD_SSE4: return "sse4";
+        case SIMD_AVX2: return "avx2";
+        default: return "scalar";
+    }
+}
+
+double SimdKernels::intersectLabels(const uint32_t *hubs_a, const double *dists_a, size_t size_a,
+                                    const uint32_t *hubs_b, const double *dists_b, size_t size_b) {
+#ifdef SIMD_X86
+    if (level_ == SIMD_AVX2) return intersectAvx2(hubs_a, dists_a, size_a, hubs_b, dists_b, size_b);
+    if (level_ == SIMD_SSE4) return intersectSse4(hubs_a, dists_a, size_a, hubs_b, dists_b, size_b);
+#endif
+    return mergeScalar(hubs_a, dists_a, 0, size_a, hubs_b, dists_b, 0, size_b, NO_SUM);
+}
+
+uint64_t SimdKernels::relaxArcs(const RoutingArc *arcs, uint32_t count, const SegmentWeights *segments, bool isDriving,
+                                const double *dist, double base) {
+#ifdef SIMD_X86
+    if (level_ == SIMD_AVX2) return relaxAvx2(arcs, count, segments, isDriving, dist, base);
+    if (level_ == SIMD_SSE4) return relaxSse4(arcs, count, segments, isDriving, dist, base);
+#endif
+    return relaxScalar(arcs, 0, count, segments, isDriving, dist, base, 0);
+}
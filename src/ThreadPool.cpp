@@ -0,0 +1,107 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+
+thread_local const ThreadPool *ThreadPool::current_pool_ = nullptr;
+thread_local int ThreadPool::current_worker_ = 0;
+int ThreadPool::shared_threads_ = 1;
+
+/************************* ThreadPool  **************************/
+
+ThreadPool::ThreadPool(int threads) {
+    threads = std::max(threads, 1);
+    for (int i = 0; i < threads; i++) queues_.push_back(std::make_unique<TaskQueue>());
+    for (int i = 1; i < threads; i++) threads_.emplace_back(&ThreadPool::work, this, i);
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    for (auto &thread : threads_) thread.join();
+}
+
+void ThreadPool::work(int worker) {
+    current_pool_ = this;
+    current_worker_ = worker;
+    while (true) {
+        if (runPending()) continue;
+        std::unique_lock<std::mutex> lock(sleep_mutex_);
+        wake_.wait(lock, [this] { return stopping_ || queued_.load() > 0; });
+        if (stopping_) return;
+    }
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+    TaskQueue &queue = *queues_[workerIndex()];
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.tasks.push_back(std::move(task));
+    }
+    queued_++;
+    // taking the lock orders the increment before the check of a worker about to sleep
+    { std::lock_guard<std::mutex> lock(sleep_mutex_); }
+    wake_.notify_one();
+}
+
+bool ThreadPool::runPending() {
+    if (queued_.load() == 0) return false;
+
+    int self = workerIndex();
+    std::function<void()> task;
+    for (int k = 0; k < size() && !task; k++) {
+        TaskQueue &queue = *queues_[(self + k) % size()];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.tasks.empty()) continue;
+        if (k == 0) {
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+        }
+        else {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+        }
+    }
+    if (!task) return false;
+
+    queued_--;
+    task();
+    return true;
+}
+
+void ThreadPool::parallelFor(size_t begin, size_t end, const std::function<void(size_t)> &body) {
+    TaskGroup group(*this);
+    for (size_t i = begin; i < end; i++) group.run([&body, i] { body(i); });
+    group.wait();
+}
+
+void ThreadPool::setSharedThreads(int threads) {
+    shared_threads_ = threads;
+}
+
+ThreadPool &ThreadPool::shared() {
+    static ThreadPool pool(shared_threads_);
+    return pool;
+}
+
+/************************* TaskGroup  **************************/
+
+void TaskGroup::run(std::function<void()> task) {
+    if (pool_.size() == 1) {
+        task();
+        return;
+    }
+    pending_++;
+    pool_.submit([this, task = std::move(task)] {
+        task();
+        pending_--;
+    });
+}
+
+void TaskGroup::wait() {
+    while (pending_.load() > 0) {
+        if (!pool_.runPending()) std::this_thread::yield();
+    }
+}
@@ -0,0 +1,97 @@
+#include "TravelTimeProfiles.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <map>
+#include <sstream>
+
+#include "InputHandler.h"
+
+void TravelTimeProfiles::clear() {
+    first_.assign(1, 0);
+    points_.clear();
+    index_.clear();
+}
+
+bool TravelTimeProfiles::parse(const std::string& profile_file) {
+    std::ifstream profiles(profile_file);
+    std::string line;
+
+    if (!std::getline(profiles,line)) {
+        return false;
+    }
+
+    std::string id, time, factor;
+    std::istringstream iss(line);
+    char sep = ',';
+    std::map<int, std::vector<ProfilePoint>> points;
+    while (std::getline(profiles,line)) {
+        iss.clear();
+        iss.str(line);
+        getline(iss,id,sep);
+        getline(iss,time,sep);
+        getline(iss,factor,sep);
+        InputHandler::trimString(factor);
+
+        int minute;
+        try {
+            ProfilePoint point = {0, float(std::stod(factor))};
+            if (!InputHandler::parseClockTime(time, minute) || !(point.factor > 0)) continue;
+            point.minute = minute;
+            points[std::stoi(id)].push_back(point);
+        }
+        catch (const std::logic_error&) {continue;} // a malformed row must not stop the profiles after it
+    }
+    profiles.close();
+
+    clear();
+    for (auto &[profile, breakpoints] : points) {
+        if (size() == NO_PROFILE) break;
+        std::stable_sort(breakpoints.begin(), breakpoints.end(),
+                         [](const ProfilePoint &a, const ProfilePoint &b) { return a.minute < b.minute; });
+        auto end = std::unique(breakpoints.begin(), breakpoints.end(),
+                               [](const ProfilePoint &a, const ProfilePoint &b) { return a.minute == b.minute; });
+        index_.emplace(profile, size());
+        points_.insert(points_.end(), breakpoints.begin(), end);
+        first_.push_back(points_.size());
+    }
+    return true;
+}
+
+uint16_t TravelTimeProfiles::find(int id) const {
+    auto it = index_.find(id);
+    if (it == index_.end()) return NO_PROFILE;
+    return it->second;
+}
+
+double TravelTimeProfiles::getFactor(uint16_t profile, double minute) const {
+    const ProfilePoint *begin = points_.data() + first_[profile];
+    const ProfilePoint *end = points_.data() + first_[profile + 1];
+    if (end - begin == 1) return begin->factor;
+
+    double t = std::fmod(minute, MINUTES_PER_DAY);
+    const ProfilePoint *next = std::upper_bound(begin, end, t, [](double t, const ProfilePoint &p) { return t < p.minute; });
+    ProfilePoint a, b;
+    if (next == begin || next == end) {
+        // between the last breakpoint of a day and the first one of the next
+        a = *(end - 1);
+        b = {begin->minute + MINUTES_PER_DAY, begin->factor};
+        if (next == begin) t += MINUTES_PER_DAY;
+    }
+    else {
+        a = *(next - 1);
+        b = *next;
+    }
+    return a.factor + (b.factor - a.factor) * (t - a.minute) / (b.minute - a.minute);
+}
+
+bool TravelTimeProfiles::isFifo(uint16_t profile, double base) const {
+    for (uint32_t i = first_[profile]; i < first_[profile + 1]; i++) {
+        ProfilePoint a = points_[i];
+        ProfilePoint b = i + 1 < first_[profile + 1] ? points_[i + 1]
+                       : ProfilePoint{points_[first_[profile]].minute + MINUTES_PER_DAY, points_[first_[profile]].factor};
+        if (base * (b.factor - a.factor) / (b.minute - a.minute) < -1) return false;
+    }
+    return true;
+}